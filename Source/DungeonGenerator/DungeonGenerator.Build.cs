@@ -33,7 +33,9 @@ public class DungeonGenerator : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"MeshDescription",
 				"NavigationSystem",
+				"StaticMeshDescription",
                 "JsonUtilities"
             });
 		if (Target.bBuildEditor)
@@ -0,0 +1,23 @@
+/**
+通路の探索方法 ヘッダーファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+#include <cstdint>
+
+namespace dungeon
+{
+	/**
+	通路の探索方法
+	*/
+	enum class AisleSearchMode : uint8_t
+	{
+		Standard,		//!< 従来のA*
+		Weighted,		//!< 重み付きA*
+		Bidirectional,	//!< 始点と終点の両側から探索する重み付きA*
+	};
+}
@@ -0,0 +1,373 @@
+/**
+階層的経路探索（HPA*）のクラスタグラフ ソースファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#include "ClusterGraph.h"
+#include "PathGoalCondition.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace dungeon
+{
+	namespace
+	{
+		inline uint32_t ManhattanDistance(const FIntVector& a, const FIntVector& b) noexcept
+		{
+			return std::abs(a.X - b.X) + std::abs(a.Y - b.Y) + std::abs(a.Z - b.Z);
+		}
+	}
+
+	ClusterGraph::ClusterGraph(const Voxel& voxel) noexcept
+		: mVoxel(voxel)
+		, mClusterWidth((static_cast<int32_t>(voxel.GetWidth()) + ClusterSize - 1) / ClusterSize)
+		, mClusterDepth((static_cast<int32_t>(voxel.GetDepth()) + ClusterSize - 1) / ClusterSize)
+		, mClusterHeight(static_cast<int32_t>(voxel.GetHeight()))
+	{
+		const size_t clusterCount = static_cast<size_t>(mClusterWidth) * mClusterDepth * mClusterHeight;
+		mCellRegions.assign(static_cast<size_t>(voxel.GetWidth()) * voxel.GetDepth() * voxel.GetHeight(), InvalidRegion);
+		mClusterRegions.resize(clusterCount);
+		mCorridor.assign(clusterCount, 0);
+
+		for (size_t clusterIndex = 0; clusterIndex < clusterCount; ++clusterIndex)
+			BuildRegions(clusterIndex);
+		for (size_t clusterIndex = 0; clusterIndex < clusterCount; ++clusterIndex)
+			BuildLinks(clusterIndex);
+	}
+
+	void ClusterGraph::Update(const Voxel::Route& route) noexcept
+	{
+		// 変化したグリッドのクラスタに加えて、境界を挟んで隣接するクラスタも更新する
+		// （隣接するクラスタの領域を端点とする接続も、変化したグリッドを経由する事があるため）
+		std::vector<size_t> clusters;
+		clusters.reserve(route.size());
+		for (const Voxel::RouteNode& node : route)
+		{
+			if (!mVoxel.Contain(node.mLocation))
+				continue;
+
+			const size_t clusterIndex = ClusterIndex(node.mLocation);
+			clusters.push_back(clusterIndex);
+
+			for (auto i = Direction::Begin(); i != Direction::End(); ++i)
+			{
+				const FIntVector neighbor = node.mLocation + *i;
+				if (mVoxel.Contain(neighbor))
+				{
+					const size_t neighborClusterIndex = ClusterIndex(neighbor);
+					if (neighborClusterIndex != clusterIndex)
+						clusters.push_back(neighborClusterIndex);
+				}
+			}
+		}
+		std::sort(clusters.begin(), clusters.end());
+		clusters.erase(std::unique(clusters.begin(), clusters.end()), clusters.end());
+
+		// 全ての領域を解放してから作り直す（解放した領域の番号を再利用するため）
+		for (const size_t clusterIndex : clusters)
+			ReleaseRegions(clusterIndex);
+		for (const size_t clusterIndex : clusters)
+			BuildRegions(clusterIndex);
+		for (const size_t clusterIndex : clusters)
+			BuildLinks(clusterIndex);
+	}
+
+	bool ClusterGraph::FindCorridor(const FIntVector& start, const FIntVector& idealGoal, const PathGoalCondition& goalCondition) noexcept
+	{
+		std::fill(mCorridor.begin(), mCorridor.end(), 0);
+
+		// ゴール範囲に隣接する領域を集める
+		std::vector<uint32_t> goalRegions;
+		const FIntRect& rect = goalCondition.Get();
+		for (int32_t y = rect.Min.Y - 1; y <= rect.Max.Y; ++y)
+		{
+			for (int32_t x = rect.Min.X - 1; x <= rect.Max.X; ++x)
+			{
+				const FIntVector location(x, y, idealGoal.Z);
+				if (goalCondition.Contains(location))
+					continue;
+
+				const bool adjacent = std::any_of(Direction::Begin(), Direction::End(), [&goalCondition, &location](const FIntVector& offset)
+					{
+						return goalCondition.Contains(location + offset);
+					}
+				);
+				if (!adjacent)
+					continue;
+
+				const uint32_t region = GetRegion(location);
+				if (region != InvalidRegion)
+					goalRegions.push_back(region);
+			}
+		}
+		if (goalRegions.empty())
+			return false;
+		std::sort(goalRegions.begin(), goalRegions.end());
+
+		// 抽象グラフをA*で探索する
+		using OpenNode = std::pair<uint32_t, uint32_t>;
+		std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode>> open;
+		std::vector<uint32_t> costs(mRegions.size(), std::numeric_limits<uint32_t>::max());
+		std::vector<uint32_t> parents(mRegions.size(), InvalidRegion);
+
+		// 始点（門）からは水平方向にしか移動できない
+		for (auto i = Direction::Begin(); i != Direction::End(); ++i)
+		{
+			const uint32_t region = GetRegion(start + *i);
+			if (region == InvalidRegion)
+				continue;
+
+			const uint32_t cost = ManhattanDistance(start, mRegions[region].mCenter);
+			if (costs[region] > cost)
+			{
+				costs[region] = cost;
+				parents[region] = region;
+				open.emplace(cost + ManhattanDistance(mRegions[region].mCenter, idealGoal), region);
+			}
+		}
+
+		uint32_t reached = InvalidRegion;
+		while (!open.empty())
+		{
+			const OpenNode node = open.top();
+			open.pop();
+
+			const uint32_t region = node.second;
+			if (node.first > costs[region] + ManhattanDistance(mRegions[region].mCenter, idealGoal))
+				continue;
+
+			if (std::binary_search(goalRegions.begin(), goalRegions.end(), region))
+			{
+				reached = region;
+				break;
+			}
+
+			for (const Link& link : mRegions[region].mLinks)
+			{
+				const uint32_t cost = costs[region] + link.mCost;
+				if (costs[link.mRegion] > cost)
+				{
+					costs[link.mRegion] = cost;
+					parents[link.mRegion] = region;
+					open.emplace(cost + ManhattanDistance(mRegions[link.mRegion].mCenter, idealGoal), link.mRegion);
+				}
+			}
+		}
+		if (reached == InvalidRegion)
+			return false;
+
+		// 選んだ領域のクラスタと、水平方向に隣接するクラスタを回廊にする
+		const auto markCorridor = [this](const size_t clusterIndex)
+			{
+				const int32_t cx = static_cast<int32_t>(clusterIndex % mClusterWidth);
+				const int32_t cy = static_cast<int32_t>((clusterIndex / mClusterWidth) % mClusterDepth);
+				const size_t layer = clusterIndex - (static_cast<size_t>(cy) * mClusterWidth + cx);
+				for (int32_t y = std::max(cy - 1, 0); y <= std::min(cy + 1, mClusterDepth - 1); ++y)
+				{
+					for (int32_t x = std::max(cx - 1, 0); x <= std::min(cx + 1, mClusterWidth - 1); ++x)
+					{
+						mCorridor[layer + static_cast<size_t>(y) * mClusterWidth + x] = 1;
+					}
+				}
+			};
+		for (uint32_t region = reached; ; region = parents[region])
+		{
+			markCorridor(mRegions[region].mCluster);
+			if (parents[region] == region)
+				break;
+		}
+		if (mVoxel.Contain(start))
+			markCorridor(ClusterIndex(start));
+
+		return true;
+	}
+
+	void ClusterGraph::ClusterBounds(const size_t clusterIndex, FIntVector& min, FIntVector& max) const noexcept
+	{
+		const int32_t cx = static_cast<int32_t>(clusterIndex % mClusterWidth);
+		const int32_t cy = static_cast<int32_t>((clusterIndex / mClusterWidth) % mClusterDepth);
+		const int32_t z = static_cast<int32_t>(clusterIndex / (static_cast<size_t>(mClusterWidth) * mClusterDepth));
+
+		min = FIntVector(cx * ClusterSize, cy * ClusterSize, z);
+		max = FIntVector(
+			std::min(min.X + ClusterSize, static_cast<int32_t>(mVoxel.GetWidth())),
+			std::min(min.Y + ClusterSize, static_cast<int32_t>(mVoxel.GetDepth())),
+			z + 1
+		);
+	}
+
+	void ClusterGraph::BuildRegions(const size_t clusterIndex) noexcept
+	{
+		FIntVector min, max;
+		ClusterBounds(clusterIndex, min, max);
+
+		std::vector<FIntVector> stack;
+		for (int32_t y = min.Y; y < max.Y; ++y)
+		{
+			for (int32_t x = min.X; x < max.X; ++x)
+			{
+				const FIntVector location(x, y, min.Z);
+				const size_t index = mVoxel.Index(location);
+				if (mVoxel[index].GetType() != Grid::Type::Empty || mCellRegions[index] != InvalidRegion)
+					continue;
+
+				uint32_t region;
+				if (mFreeRegions.empty())
+				{
+					region = static_cast<uint32_t>(mRegions.size());
+					mRegions.emplace_back();
+				}
+				else
+				{
+					region = mFreeRegions.back();
+					mFreeRegions.pop_back();
+				}
+
+				// クラスタ内で連結している空きグリッドを塗りつぶす
+				FIntVector sum(0, 0, 0);
+				int32_t count = 0;
+				mCellRegions[index] = region;
+				stack.push_back(location);
+				while (!stack.empty())
+				{
+					const FIntVector current = stack.back();
+					stack.pop_back();
+					sum += current;
+					++count;
+
+					for (auto i = Direction::Begin(); i != Direction::End(); ++i)
+					{
+						const FIntVector next = current + *i;
+						if (next.X < min.X || max.X <= next.X || next.Y < min.Y || max.Y <= next.Y)
+							continue;
+
+						const size_t nextIndex = mVoxel.Index(next);
+						if (mVoxel[nextIndex].GetType() == Grid::Type::Empty && mCellRegions[nextIndex] == InvalidRegion)
+						{
+							mCellRegions[nextIndex] = region;
+							stack.push_back(next);
+						}
+					}
+				}
+
+				Region& newRegion = mRegions[region];
+				newRegion.mCenter = FIntVector(sum.X / count, sum.Y / count, min.Z);
+				newRegion.mCluster = clusterIndex;
+				newRegion.mLinks.clear();
+				mClusterRegions[clusterIndex].push_back(region);
+			}
+		}
+	}
+
+	void ClusterGraph::ReleaseRegions(const size_t clusterIndex) noexcept
+	{
+		for (const uint32_t region : mClusterRegions[clusterIndex])
+		{
+			// 接続先から自身への接続を外す
+			for (const Link& link : mRegions[region].mLinks)
+			{
+				std::vector<Link>& links = mRegions[link.mRegion].mLinks;
+				links.erase(std::remove_if(links.begin(), links.end(), [region](const Link& other)
+					{
+						return other.mRegion == region;
+					}
+				), links.end());
+			}
+			mRegions[region].mLinks.clear();
+			mFreeRegions.push_back(region);
+		}
+		mClusterRegions[clusterIndex].clear();
+
+		FIntVector min, max;
+		ClusterBounds(clusterIndex, min, max);
+		for (int32_t y = min.Y; y < max.Y; ++y)
+		{
+			for (int32_t x = min.X; x < max.X; ++x)
+			{
+				mCellRegions[mVoxel.Index(x, y, min.Z)] = InvalidRegion;
+			}
+		}
+	}
+
+	void ClusterGraph::BuildLinks(const size_t clusterIndex) noexcept
+	{
+		static const FIntVector up(0, 0, 1);
+
+		// 隣り合うグリッドは同じ領域の組を接続する事が多いので、直前の組は省略する
+		uint32_t lastA = InvalidRegion;
+		uint32_t lastB = InvalidRegion;
+		const auto addLink = [this, &lastA, &lastB](const uint32_t a, const uint32_t b)
+			{
+				if (a == lastA && b == lastB)
+					return;
+				lastA = a;
+				lastB = b;
+				AddLink(a, b);
+			};
+
+		FIntVector min, max;
+		ClusterBounds(clusterIndex, min, max);
+		for (int32_t y = min.Y; y < max.Y; ++y)
+		{
+			for (int32_t x = min.X; x < max.X; ++x)
+			{
+				const FIntVector location(x, y, min.Z);
+				const uint32_t region = GetRegion(location);
+				if (region == InvalidRegion)
+					continue;
+
+				for (auto i = Direction::Begin(); i != Direction::End(); ++i)
+				{
+					// 隣接するクラスタとの境界
+					const FIntVector forward = location + *i;
+					const uint32_t forwardRegion = GetRegion(forward);
+					if (forwardRegion != InvalidRegion && mRegions[forwardRegion].mCluster != clusterIndex)
+						addLink(region, forwardRegion);
+
+					// 自身を下端とする階段（上階段の U, F, UF が空いている）
+					if (forwardRegion != InvalidRegion &&
+						GetRegion(location + up) != InvalidRegion)
+					{
+						const uint32_t upperRegion = GetRegion(forward + up);
+						if (upperRegion != InvalidRegion)
+							addLink(region, upperRegion);
+					}
+
+					// 自身を上端とする階段
+					const FIntVector lower = location - *i - up;
+					const uint32_t lowerRegion = GetRegion(lower);
+					if (lowerRegion != InvalidRegion &&
+						GetRegion(location - up) != InvalidRegion &&
+						GetRegion(location - *i) != InvalidRegion)
+					{
+						addLink(lowerRegion, region);
+					}
+				}
+			}
+		}
+	}
+
+	void ClusterGraph::AddLink(const uint32_t a, const uint32_t b) noexcept
+	{
+		if (a == b)
+			return;
+
+		std::vector<Link>& links = mRegions[a].mLinks;
+		const bool exists = std::any_of(links.begin(), links.end(), [b](const Link& link)
+			{
+				return link.mRegion == b;
+			}
+		);
+		if (exists)
+			return;
+
+		const uint32_t cost = ManhattanDistance(mRegions[a].mCenter, mRegions[b].mCenter) + 1;
+		links.push_back({ b, cost });
+		mRegions[b].mLinks.push_back({ a, cost });
+	}
+}
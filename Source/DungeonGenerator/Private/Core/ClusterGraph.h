@@ -0,0 +1,116 @@
+/**
+階層的経路探索（HPA*）のクラスタグラフ ヘッダーファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+#include "Voxel.h"
+#include <cstdint>
+#include <vector>
+
+namespace dungeon
+{
+	// 前方宣言
+	class PathGoalCondition;
+
+	/**
+	階層的経路探索（HPA*）のクラスタグラフクラス
+	ボクセル空間を水平方向にClusterSize四方、垂直方向に1グリッドのクラスタに分割し、
+	クラスタ内で連結している空きグリッドを領域として抽象グラフのノードにします。
+	領域間の入口（隣接するクラスタとの境界と階段を置ける場所）を事前に計算しておき、
+	抽象グラフを探索して選んだ回廊の中だけでA*を詳細化します。
+	通路を確定するたびに、通路が通過したクラスタと隣接するクラスタだけを更新します。
+	*/
+	class ClusterGraph final
+	{
+	public:
+		//! クラスタの水平方向の大きさ
+		static constexpr int32_t ClusterSize = 8;
+
+	public:
+		/**
+		コンストラクタ
+		全てのクラスタの領域と入口を計算します
+		\param[in]	voxel	ボクセル
+		*/
+		explicit ClusterGraph(const Voxel& voxel) noexcept;
+		ClusterGraph(const ClusterGraph&) = delete;
+		ClusterGraph& operator=(const ClusterGraph&) = delete;
+
+		/**
+		デストラクタ
+		*/
+		~ClusterGraph() = default;
+
+		/**
+		確定した通路が通過したクラスタと、境界を挟んで隣接するクラスタを更新します
+		\param[in]	route	ボクセルに書き込んだ経路
+		*/
+		void Update(const Voxel::Route& route) noexcept;
+
+		/**
+		抽象グラフを探索して回廊を選びます
+		\param[in]	start			始点
+		\param[in]	idealGoal		理想的な終点
+		\param[in]	goalCondition	終了条件
+		\return		falseならば抽象グラフ上で到達できない
+		*/
+		bool FindCorridor(const FIntVector& start, const FIntVector& idealGoal, const PathGoalCondition& goalCondition) noexcept;
+
+		/**
+		座標が最後に選んだ回廊に含まれるか調べます
+		\param[in]	location	座標
+		\return		trueならば回廊に含まれる
+		*/
+		bool IsInCorridor(const FIntVector& location) const noexcept;
+
+	private:
+		static constexpr uint32_t InvalidRegion = ~static_cast<uint32_t>(0);
+
+		/**
+		領域間の接続
+		*/
+		struct Link final
+		{
+			uint32_t mRegion;
+			uint32_t mCost;
+		};
+
+		/**
+		クラスタ内で連結している空きグリッドの集合
+		*/
+		struct Region final
+		{
+			FIntVector mCenter;
+			size_t mCluster;
+			std::vector<Link> mLinks;
+		};
+
+		size_t ClusterIndex(const FIntVector& location) const noexcept;
+		void ClusterBounds(const size_t clusterIndex, FIntVector& min, FIntVector& max) const noexcept;
+		uint32_t GetRegion(const FIntVector& location) const noexcept;
+
+		void BuildRegions(const size_t clusterIndex) noexcept;
+		void ReleaseRegions(const size_t clusterIndex) noexcept;
+		void BuildLinks(const size_t clusterIndex) noexcept;
+		void AddLink(const uint32_t a, const uint32_t b) noexcept;
+
+	private:
+		const Voxel& mVoxel;
+		int32_t mClusterWidth;
+		int32_t mClusterDepth;
+		int32_t mClusterHeight;
+
+		std::vector<uint32_t> mCellRegions;
+		std::vector<std::vector<uint32_t>> mClusterRegions;
+		std::vector<Region> mRegions;
+		std::vector<uint32_t> mFreeRegions;
+
+		std::vector<uint8_t> mCorridor;
+	};
+}
+
+#include "ClusterGraph.inl"
@@ -0,0 +1,33 @@
+/**
+階層的経路探索（HPA*）のクラスタグラフ インラインファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+
+namespace dungeon
+{
+	inline size_t ClusterGraph::ClusterIndex(const FIntVector& location) const noexcept
+	{
+		return
+			(static_cast<size_t>(location.Z) * mClusterDepth + static_cast<size_t>(location.Y / ClusterSize)) * mClusterWidth
+			+ static_cast<size_t>(location.X / ClusterSize);
+	}
+
+	inline uint32_t ClusterGraph::GetRegion(const FIntVector& location) const noexcept
+	{
+		if (!mVoxel.Contain(location))
+			return InvalidRegion;
+		return mCellRegions[mVoxel.Index(location)];
+	}
+
+	inline bool ClusterGraph::IsInCorridor(const FIntVector& location) const noexcept
+	{
+		if (!mVoxel.Contain(location))
+			return false;
+		return mCorridor[ClusterIndex(location)] != 0;
+	}
+}
@@ -41,12 +41,14 @@ namespace dungeon
 		/**
 		三角形を更新します
 		*/
-		void ForEach(std::function<void(const Triangle&)> func) noexcept;
+		template<typename Function>
+		void ForEach(Function&& func) noexcept;
 
 		/**
 		三角形を更新します
 		*/
-		void ForEach(std::function<void(const Triangle&)> func) const noexcept;
+		template<typename Function>
+		void ForEach(Function&& func) const noexcept;
 
 		/**
 		有効な分割か調べます
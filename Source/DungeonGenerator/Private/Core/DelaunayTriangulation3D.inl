@@ -11,7 +11,8 @@ All Rights Reserved.
 
 namespace dungeon
 {
-	inline void DelaunayTriangulation3D::ForEach(std::function<void(const Triangle&)> func) noexcept
+	template<typename Function>
+	inline void DelaunayTriangulation3D::ForEach(Function&& func) noexcept
 	{
 		for (auto& triangle : mTriangles)
 		{
@@ -19,7 +20,8 @@ namespace dungeon
 		}
 	}
 
-	inline void DelaunayTriangulation3D::ForEach(std::function<void(const Triangle&)> func) const noexcept
+	template<typename Function>
+	inline void DelaunayTriangulation3D::ForEach(Function&& func) const noexcept
 	{
 		for (auto& triangle : mTriangles)
 		{
@@ -84,6 +84,6 @@ namespace dungeon
 
 	inline Direction Direction::CreateFromRandom(Random& random) noexcept
 	{
-		return Direction(static_cast<Direction::Index>(random.Get<int32_t>() % 4));
+		return Direction(static_cast<Direction::Index>(random.Get<uint32_t>() % 4));
 	}
 }
@@ -0,0 +1,116 @@
+/**
+グリッド毎に生成するメッシュの判定結果 ソースファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#include "FeatureMask.h"
+#include "GridRuleTable.h"
+#include "Voxel.h"
+
+namespace dungeon
+{
+	FeatureMask::FeatureMask(const Voxel& voxel, const bool mergeRooms)
+		: mMasks(static_cast<size_t>(voxel.GetWidth()) * voxel.GetDepth() * voxel.GetHeight(), 0)
+	{
+		// 書き込み先はグリッド毎に異なるので、Z方向の断面毎に並列に判定する
+		voxel.ParallelEach([this, &voxel, mergeRooms](const FIntVector& location, const Grid& grid)
+			{
+				uint16_t mask = 0;
+
+				// 斜面と床
+				if (grid.CanBuildSlope())
+				{
+					mask |= Slope;
+				}
+				else if (grid.CanBuildFloor(voxel.Get(location.X, location.Y, location.Z - 1), false))
+				{
+					mask |= Floor;
+					if (!grid.IsNoFloorMeshGeneration())
+						mask |= FloorMesh;
+				}
+
+				// 壁と扉
+				for (uint8_t i = 0; i < 4; ++i)
+				{
+					const Direction::Index direction = static_cast<Direction::Index>(i);
+					const FIntVector& vector = Direction::GetVector(direction);
+					const Grid& toGrid = voxel.Get(location.X + vector.X, location.Y + vector.Y, location.Z);
+					if (grid.CanBuildWall(toGrid, direction, mergeRooms))
+						mask |= Wall(direction);
+					if (grid.CanBuildGate(toGrid, direction))
+						mask |= Gate(direction);
+				}
+
+				// 屋根
+				if (grid.CanBuildRoof(voxel.Get(location.X, location.Y, location.Z + 1), true))
+					mask |= RoofMesh;
+
+				// 柱の周囲2x2の壁と床
+				uint16_t wallCount = 0;
+				for (int32_t dy = -1; dy <= 0; ++dy)
+				{
+					for (int32_t dx = -1; dx <= 0; ++dx)
+					{
+						const Grid& baseFloorGrid = voxel.Get(location.X + dx, location.Y + dy, location.Z);
+						if (grid.CanBuildPillar(baseFloorGrid))
+							++wallCount;
+
+						const Grid& underFloorGrid = voxel.Get(location.X + dx, location.Y + dy, location.Z - 1);
+						if (baseFloorGrid.CanBuildSlope() || baseFloorGrid.CanBuildFloor(underFloorGrid, false))
+							mask |= PillarOnFloor;
+					}
+				}
+				mask |= wallCount << PillarWallCountShift;
+
+				mMasks[voxel.Index(location)] = mask;
+			}
+		);
+
+		// 屋根の表の行（参照先の種類のビット）が同じ種類は同じ高さを共有する
+		constexpr uint64_t rowMask = (static_cast<uint64_t>(1) << GridRuleTable::TypeSize) - 1;
+		constexpr uint64_t outOfBoundsBit = static_cast<uint64_t>(1) << GridRuleTable::OutOfBounds;
+		std::array<uint64_t, GridRuleTable::TypeSize> slotRows;
+		mHeadroomSlots.fill(NoHeadroomSlot);
+		for (uint8_t type = 0; type < GridRuleTable::TypeSize; ++type)
+		{
+			const uint64_t row = (GridRuleTable::RoofTable >> GridRuleTable::Index(type, 0)) & rowMask & ~outOfBoundsBit;
+			if (row == 0)
+				continue;
+
+			size_t slot = 0;
+			while (slot < mHeadroomSlotCount && slotRows[slot] != row)
+				++slot;
+			if (slot == mHeadroomSlotCount)
+				slotRows[mHeadroomSlotCount++] = row;
+			mHeadroomSlots[type] = static_cast<uint8_t>(slot);
+		}
+
+		// 天井までの高さは上のグリッドの結果を使うので、列毎に上から一度だけ走査する
+		mHeadrooms.assign(mMasks.size() * mHeadroomSlotCount, 0);
+		const uint32_t height = voxel.GetHeight();
+		for (uint32_t y = 0; y < voxel.GetDepth(); ++y)
+		{
+			for (uint32_t x = 0; x < voxel.GetWidth(); ++x)
+			{
+				std::array<uint16_t, GridRuleTable::TypeSize> headrooms{};
+				for (uint32_t z = height; z-- > 0;)
+				{
+					const size_t index = voxel.Index(x, y, z) * mHeadroomSlotCount;
+
+					// 最上段の上は範囲外なので頭上の空間は無い
+					const uint64_t roofBit = z + 1 < height ?
+						static_cast<uint64_t>(1) << static_cast<uint8_t>(voxel.Get(x, y, z + 1).GetType()) :
+						0;
+					for (size_t slot = 0; slot < mHeadroomSlotCount; ++slot)
+					{
+						headrooms[slot] = (slotRows[slot] & roofBit) ? static_cast<uint16_t>(headrooms[slot] + 1) : 0;
+						mHeadrooms[index + slot] = headrooms[slot];
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,129 @@
+/**
+グリッド毎に生成するメッシュの判定結果 ヘッダーファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+#include "Direction.h"
+#include "Grid.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dungeon
+{
+	// 前方宣言
+	class Voxel;
+
+	/**
+	グリッド毎に生成するメッシュの判定結果クラス
+	Grid::CanBuild系の判定を一度だけ並列に評価してビットに記録します。
+	地形の生成とミニマップの描画は、近傍のグリッドを調べずにビットを参照します。
+	天井までの高さは列毎に上から一度だけ走査して記録します。
+	*/
+	class FeatureMask final
+	{
+	public:
+		/**
+		判定結果のビット
+		*/
+		enum Feature : uint16_t
+		{
+			Slope = 1 << 0,					//!< 斜面
+			Floor = 1 << 1,					//!< 床（メッシュ生成禁止を無視）
+			FloorMesh = 1 << 2,				//!< 床のメッシュ
+			WallNorth = 1 << 3,				//!< 北側の壁
+			WallEast = 1 << 4,				//!< 東側の壁
+			WallSouth = 1 << 5,				//!< 南側の壁
+			WallWest = 1 << 6,				//!< 西側の壁
+			GateNorth = 1 << 7,				//!< 北側の扉
+			GateEast = 1 << 8,				//!< 東側の扉
+			GateSouth = 1 << 9,				//!< 南側の扉
+			GateWest = 1 << 10,				//!< 西側の扉
+			RoofMesh = 1 << 11,				//!< 屋根のメッシュ
+			PillarOnFloor = 1 << 12,		//!< 柱の周囲2x2に床がある
+		};
+
+		//! 柱の周囲2x2にある壁の数のビット位置
+		static constexpr uint16_t PillarWallCountShift = 13;
+		static constexpr uint16_t PillarWallCountMask = 0x7 << PillarWallCountShift;
+
+		//! 壁と扉のビットはDirection::Indexの順に並べる
+		static_assert(WallEast == WallNorth << Direction::East && WallWest == WallNorth << Direction::West, "Wall bits must follow Direction::Index");
+		static_assert(GateEast == GateNorth << Direction::East && GateWest == GateNorth << Direction::West, "Gate bits must follow Direction::Index");
+
+	public:
+		/**
+		コンストラクタ
+		\param[in]	voxel		ボクセル
+		\param[in]	mergeRooms	部屋と部屋の間に壁を生成しないならtrue
+		*/
+		FeatureMask(const Voxel& voxel, const bool mergeRooms);
+		FeatureMask(const FeatureMask&) = delete;
+		FeatureMask& operator=(const FeatureMask&) = delete;
+
+		/**
+		デストラクタ
+		*/
+		~FeatureMask() = default;
+
+		/**
+		判定結果を取得します
+		\param[in]	index	Voxel::Indexのインデックス
+		\return		Featureの論理和
+		*/
+		uint16_t Get(const size_t index) const noexcept;
+
+		/**
+		判定結果を調べます
+		\param[in]	index	Voxel::Indexのインデックス
+		\param[in]	feature	判定結果のビット
+		\return		trueならば生成する
+		*/
+		bool Test(const size_t index, const Feature feature) const noexcept;
+
+		/**
+		柱の周囲2x2にある壁の数を取得します
+		\param[in]	index	Voxel::Indexのインデックス
+		\return		壁の数（0〜4）
+		*/
+		uint8_t GetPillarWallCount(const size_t index) const noexcept;
+
+		/**
+		グリッドの上に続く、gridから見て屋根を生成できるグリッドの数を取得します
+		Grid::CanBuildRoofで上に向かって調べた結果と一致します。
+		柱の高さや、頭上の空間が必要な配置に使います
+		\param[in]	index	Voxel::Indexのインデックス
+		\param[in]	grid	屋根を判定するグリッド
+		\return		頭上のグリッドの数（真上が屋根を生成できないなら0）
+		*/
+		uint16_t GetHeadroom(const size_t index, const Grid& grid) const noexcept;
+
+		/**
+		方向に対応する壁のビットを取得します
+		\param[in]	direction	方向
+		*/
+		static constexpr Feature Wall(const Direction::Index direction) noexcept;
+
+		/**
+		方向に対応する扉のビットを取得します
+		\param[in]	direction	方向
+		*/
+		static constexpr Feature Gate(const Direction::Index direction) noexcept;
+
+	private:
+		std::vector<uint16_t> mMasks;
+
+		// 屋根の判定は自身の種類に依存するので、屋根の表の行が同じ種類毎に高さを記録する
+		static constexpr uint8_t NoHeadroomSlot = 0xff;
+		std::array<uint8_t, Grid::TypeSize> mHeadroomSlots;
+		size_t mHeadroomSlotCount = 0;
+		std::vector<uint16_t> mHeadrooms;
+	};
+}
+
+#include "FeatureMask.inl"
@@ -0,0 +1,43 @@
+/**
+グリッド毎に生成するメッシュの判定結果 インラインファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+
+namespace dungeon
+{
+	inline uint16_t FeatureMask::Get(const size_t index) const noexcept
+	{
+		return mMasks[index];
+	}
+
+	inline bool FeatureMask::Test(const size_t index, const Feature feature) const noexcept
+	{
+		return (mMasks[index] & feature) != 0;
+	}
+
+	inline uint8_t FeatureMask::GetPillarWallCount(const size_t index) const noexcept
+	{
+		return static_cast<uint8_t>((mMasks[index] & PillarWallCountMask) >> PillarWallCountShift);
+	}
+
+	inline uint16_t FeatureMask::GetHeadroom(const size_t index, const Grid& grid) const noexcept
+	{
+		const uint8_t slot = mHeadroomSlots[static_cast<size_t>(grid.GetType())];
+		return slot == NoHeadroomSlot ? 0 : mHeadrooms[index * mHeadroomSlotCount + slot];
+	}
+
+	inline constexpr FeatureMask::Feature FeatureMask::Wall(const Direction::Index direction) noexcept
+	{
+		return static_cast<Feature>(WallNorth << static_cast<uint8_t>(direction));
+	}
+
+	inline constexpr FeatureMask::Feature FeatureMask::Gate(const Direction::Index direction) noexcept
+	{
+		return static_cast<Feature>(GateNorth << static_cast<uint8_t>(direction));
+	}
+}
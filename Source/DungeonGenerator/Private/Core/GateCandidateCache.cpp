@@ -0,0 +1,188 @@
+/**
+部屋の外周にある門の候補 ソースファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#include "GateCandidateCache.h"
+#include "PathGoalCondition.h"
+#include "SearchContext.h"
+#include <algorithm>
+
+namespace dungeon
+{
+	namespace
+	{
+		inline int64_t SquaredDistance(const FIntVector& a, const FIntVector& b) noexcept
+		{
+			const FIntVector delta = b - a;
+			return
+				static_cast<int64_t>(delta.X * delta.X) +
+				static_cast<int64_t>(delta.Y * delta.Y) +
+				static_cast<int64_t>(delta.Z * delta.Z);
+		}
+	}
+
+	GateCandidateCache::GateCandidateCache(const Voxel& voxel) noexcept
+		: mVoxel(voxel)
+	{
+	}
+
+	void GateCandidateCache::Add(const Identifier& identifier, const FIntRect& rect, const int32_t z) noexcept
+	{
+		Room room;
+		room.mRect = rect;
+		room.mZ = z;
+		for (int32_t y = rect.Min.Y; y < rect.Max.Y; ++y)
+		{
+			for (int32_t x = rect.Min.X; x < rect.Max.X; ++x)
+			{
+				// 外周だけを調べる
+				if (rect.Min.X < x && x < rect.Max.X - 1 && rect.Min.Y < y && y < rect.Max.Y - 1)
+					continue;
+
+				const FIntVector location(x, y, z);
+				if (IsCandidate(location))
+					room.mCandidates.push_back(location);
+			}
+		}
+
+		mRoomIndices[identifier.Get()] = mRooms.size();
+		mRooms.emplace_back(std::move(room));
+	}
+
+	void GateCandidateCache::Update(const Voxel::Route& route) noexcept
+	{
+		// 門になった床グリッドと、空きグリッドが埋まった事で候補でなくなったかもしれない隣の床グリッドの部屋
+		std::vector<uint16_t> identifiers;
+		for (const Voxel::RouteNode& node : route)
+		{
+			identifiers.push_back(mVoxel.Get(node.mLocation.X, node.mLocation.Y, node.mLocation.Z).GetIdentifier());
+			for (auto i = Direction::Begin(); i != Direction::End(); ++i)
+			{
+				const FIntVector location = node.mLocation + *i;
+				const Grid& grid = mVoxel.Get(location.X, location.Y, location.Z);
+				if (grid.GetType() == Grid::Type::Deck)
+					identifiers.push_back(grid.GetIdentifier());
+			}
+		}
+		std::sort(identifiers.begin(), identifiers.end());
+		identifiers.erase(std::unique(identifiers.begin(), identifiers.end()), identifiers.end());
+
+		for (const uint16_t identifier : identifiers)
+			Refresh(identifier);
+	}
+
+	bool GateCandidateCache::Find(FIntVector& result, const FIntVector& start, const FIntVector& goal, const PathGoalCondition& goalCondition, SearchContext& context) const noexcept
+	{
+		const Room* startRoom = FindRoom(start);
+		if (startRoom == nullptr || startRoom->mCandidates.empty())
+			return false;
+
+		const Room& room = *startRoom;
+
+		/*
+		高さが違うゴールに最も近い候補を選ぶと、階段を置く余地の無い門になりやすく
+		A*が大きく迂回するので床を探索する
+		*/
+		if (room.mZ != goal.Z)
+			return false;
+
+		// ゴール範囲に接する部屋は、ゴール範囲に直接門を置けるので床を探索する
+		const FIntRect& goalRect = goalCondition.Get();
+		if (room.mRect.Min.X - 1 < goalRect.Max.X && goalRect.Min.X < room.mRect.Max.X + 1 &&
+			room.mRect.Min.Y - 1 < goalRect.Max.Y && goalRect.Min.Y < room.mRect.Max.Y + 1)
+			return false;
+
+		// 候補は全て門を置けるので、ゴールに最も近い候補を選ぶ
+		const auto nearest = std::min_element(room.mCandidates.begin(), room.mCandidates.end(), [&goal](const FIntVector& l, const FIntVector& r)
+			{
+				return SquaredDistance(l, goal) < SquaredDistance(r, goal);
+			}
+		);
+
+		/*
+		先に確定した通路は候補を減らすだけなので、
+		選んだ候補とその周囲が変わらなければ結果も変わらない
+		*/
+		context.TrackRead(mVoxel.Index(*nearest));
+		for (auto i = Direction::Begin(); i != Direction::End(); ++i)
+		{
+			const FIntVector location = *nearest + *i;
+			if (mVoxel.Contain(location))
+				context.TrackRead(mVoxel.Index(location));
+		}
+
+		result = *nearest;
+		return true;
+	}
+
+	uint64_t GateCandidateCache::Hash(const FIntVector& start) const noexcept
+	{
+		const Room* room = FindRoom(start);
+		if (room == nullptr)
+			return 0;
+
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ull;
+		const auto combine = [&hash](const int32_t value)
+			{
+				hash ^= static_cast<uint32_t>(value);
+				hash *= 1099511628211ull;
+			};
+		combine(static_cast<int32_t>(room->mCandidates.size()));
+		for (const FIntVector& candidate : room->mCandidates)
+		{
+			combine(candidate.X);
+			combine(candidate.Y);
+			combine(candidate.Z);
+		}
+		return hash;
+	}
+
+	const GateCandidateCache::Room* GateCandidateCache::FindRoom(const FIntVector& start) const noexcept
+	{
+		const Grid& startGrid = mVoxel.Get(start.X, start.Y, start.Z);
+		if (startGrid.GetType() != Grid::Type::Deck)
+			return nullptr;
+
+		const auto roomIndex = mRoomIndices.find(startGrid.GetIdentifier());
+		if (roomIndex == mRoomIndices.end())
+			return nullptr;
+
+		const Room& room = mRooms[roomIndex->second];
+		if (room.mZ != start.Z)
+			return nullptr;
+
+		return &room;
+	}
+
+	bool GateCandidateCache::IsCandidate(const FIntVector& location) const noexcept
+	{
+		if (mVoxel.Get(location.X, location.Y, location.Z).GetType() != Grid::Type::Deck)
+			return false;
+
+		return std::any_of(Direction::Begin(), Direction::End(), [this, &location](const FIntVector& offset)
+			{
+				const FIntVector neighbor = location + offset;
+				return mVoxel.Get(neighbor.X, neighbor.Y, neighbor.Z).GetType() == Grid::Type::Empty;
+			}
+		);
+	}
+
+	void GateCandidateCache::Refresh(const uint16_t identifier) noexcept
+	{
+		const auto roomIndex = mRoomIndices.find(identifier);
+		if (roomIndex == mRoomIndices.end())
+			return;
+
+		std::vector<FIntVector>& candidates = mRooms[roomIndex->second].mCandidates;
+		candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [this](const FIntVector& location)
+			{
+				return !IsCandidate(location);
+			}
+		), candidates.end());
+	}
+}
@@ -0,0 +1,97 @@
+/**
+部屋の外周にある門の候補 ヘッダーファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+#include "Voxel.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace dungeon
+{
+	// 前方宣言
+	class PathGoalCondition;
+	class SearchContext;
+
+	/**
+	部屋の外周にある門の候補クラス
+	部屋毎に、空きグリッドに接している床グリッドを記録します。
+	通路の確定で候補が増える事は無いので、確定した通路に隣接する部屋の候補から
+	門を置けなくなったグリッドを取り除くだけで常に正しい候補を保てます。
+	*/
+	class GateCandidateCache final
+	{
+	public:
+		/**
+		コンストラクタ
+		\param[in]	voxel	ボクセル
+		*/
+		explicit GateCandidateCache(const Voxel& voxel) noexcept;
+		GateCandidateCache(const GateCandidateCache&) = delete;
+		GateCandidateCache& operator=(const GateCandidateCache&) = delete;
+
+		/**
+		デストラクタ
+		*/
+		~GateCandidateCache() = default;
+
+		/**
+		部屋の外周から門の候補を集めます
+		部屋をボクセルに書き込んだ後に呼び出して下さい
+		\param[in]	identifier	部屋の識別子
+		\param[in]	rect		部屋の範囲
+		\param[in]	z			部屋の床の高さ
+		*/
+		void Add(const Identifier& identifier, const FIntRect& rect, const int32_t z) noexcept;
+
+		/**
+		確定した通路に隣接する部屋の候補を更新します
+		\param[in]	route	ボクセルに書き込んだ経路
+		*/
+		void Update(const Voxel::Route& route) noexcept;
+
+		/**
+		startを含む部屋の候補から、goalに最も近い門の位置を探します
+		\param[out]	result			門の位置
+		\param[in]	start			部屋の中の始点
+		\param[in]	goal			ゴール位置
+		\param[in]	goalCondition	終了条件
+		\param[in]	context			参照を記録する経路探索コンテキスト
+		\return		falseならば候補から決められないので、床を探索して下さい
+		*/
+		bool Find(FIntVector& result, const FIntVector& start, const FIntVector& goal, const PathGoalCondition& goalCondition, SearchContext& context) const noexcept;
+
+		/**
+		startを含む部屋の候補のハッシュ値を取得します
+		候補が同じならFindの結果も同じになるので、探索結果を再利用できるか調べるのに使います
+		\param[in]	start	部屋の中の始点
+		\return		部屋が見つからなければ0
+		*/
+		uint64_t Hash(const FIntVector& start) const noexcept;
+
+	private:
+		/**
+		部屋の門の候補
+		*/
+		struct Room final
+		{
+			FIntRect mRect;
+			int32_t mZ;
+			std::vector<FIntVector> mCandidates;
+		};
+
+		const Room* FindRoom(const FIntVector& start) const noexcept;
+		bool IsCandidate(const FIntVector& location) const noexcept;
+		void Refresh(const uint16_t identifier) noexcept;
+
+	private:
+		const Voxel& mVoxel;
+		std::vector<Room> mRooms;
+		std::unordered_map<uint16_t, size_t> mRoomIndices;
+	};
+}
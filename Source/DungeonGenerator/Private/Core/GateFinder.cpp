@@ -7,12 +7,32 @@ All Rights Reserved.
 */
 
 #include "GateFinder.h"
+#include <algorithm>
 
 namespace dungeon
 {
-	GateFinder::Gate::Gate(const FIntVector& location, const int64_t squaredDistance)
+	namespace
+	{
+		inline uint64_t Hash(const FIntVector& location) noexcept
+		{
+			return
+				static_cast<uint64_t>(location.Z) << 44 |
+				static_cast<uint64_t>(location.Y) << 22 |
+				static_cast<uint64_t>(location.X);
+		}
+
+		inline bool Greater(const GateFinder::Gate& l, const GateFinder::Gate& r) noexcept
+		{
+			if (l.mSquaredDistance != r.mSquaredDistance)
+				return l.mSquaredDistance > r.mSquaredDistance;
+			return l.mOrder > r.mOrder;
+		}
+	}
+
+	GateFinder::Gate::Gate(const FIntVector& location, const int64_t squaredDistance, const uint32_t order)
 		: mLocation(location)
 		, mSquaredDistance(squaredDistance)
+		, mOrder(order)
 	{
 	}
 
@@ -21,22 +41,16 @@ namespace dungeon
 		Entry(start, goal);
 	}
 
+	GateFinder::GateFinder(const FIntVector& start, const FIntVector& goal, ScratchArena& arena)
+		: mOpenGates(Gates::allocator_type(&arena))
+		, mVisited(Visited::allocator_type(&arena))
+	{
+		Entry(start, goal);
+	}
+
 	void GateFinder::Entry(const FIntVector& start, const FIntVector& goal)
 	{
-		const auto closeGate = std::find_if(mCloseGates.begin(), mCloseGates.end(), [&start](const std::shared_ptr<const Gate>& gate)
-			{
-				return start == gate->mLocation;
-			}
-		);
-		if (closeGate != mCloseGates.end())
-			return;
-		
-		const auto openGate = std::find_if(mOpenGates.begin(), mOpenGates.end(), [&start](const std::shared_ptr<const Gate>& gate)
-			{
-				return start == gate->mLocation;
-			}
-		);
-		if (openGate != mOpenGates.end())
+		if (!mVisited.emplace(Hash(start)).second)
 			return;
 
 		const FIntVector delta = goal - start;
@@ -44,31 +58,30 @@ namespace dungeon
 			static_cast<int64_t>(delta.X * delta.X) +
 			static_cast<int64_t>(delta.Y * delta.Y) +
 			static_cast<int64_t>(delta.Z * delta.Z);
-		mOpenGates.emplace_back(std::make_shared<const Gate>(start, squaredLength));
+		mOpenGates.emplace_back(start, squaredLength, mOrder++);
+		std::push_heap(mOpenGates.begin(), mOpenGates.end(), Greater);
 	}
 
 	bool GateFinder::Pop(FIntVector& result)
 	{
-		auto nearestGate = mOpenGates.begin();
-		int64_t nearestDistance = std::numeric_limits<int64_t>::max();
-
-		for (std::vector<std::shared_ptr<const Gate>>::iterator i = mOpenGates.begin(); i != mOpenGates.end(); ++i)
-		{
-			if (nearestDistance > (*i)->mSquaredDistance)
-			{
-				nearestDistance = (*i)->mSquaredDistance;
-				nearestGate = i;
-			}
-		}
-
-		if (nearestGate == mOpenGates.end())
+		if (mOpenGates.empty())
 			return false;
 
-		result = (*nearestGate)->mLocation;
-
-		mCloseGates.push_back(*nearestGate);
-		mOpenGates.erase(nearestGate);
+		std::pop_heap(mOpenGates.begin(), mOpenGates.end(), Greater);
+		result = mOpenGates.back().mLocation;
+		mOpenGates.pop_back();
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		++mClosedCount;
+#endif
 
 		return true;
 	}
+
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+	void GateFinder::AddStatistics(SearchStatistics& statistics) const noexcept
+	{
+		statistics.mGateOpenedNodeCount += mOrder;
+		statistics.mGateClosedNodeCount += mClosedCount;
+	}
+#endif
 }
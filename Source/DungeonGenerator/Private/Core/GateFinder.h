@@ -7,7 +7,10 @@ All Rights Reserved.
 */
 
 #pragma once
-#include <memory>
+#include "ScratchArena.h"
+#include "SearchStatistics.h"
+#include <functional>
+#include <unordered_set>
 #include <vector>
 #include <Math/IntVector.h>
 
@@ -20,20 +23,36 @@ namespace dungeon
 		{
 			FIntVector mLocation;
 			int64_t mSquaredDistance;
+			uint32_t mOrder;
 
-			Gate(const FIntVector& location, const int64_t squaredDistance);
+			Gate(const FIntVector& location, const int64_t squaredDistance, const uint32_t order);
 		};
 
 	public:
 		GateFinder(const FIntVector& start, const FIntVector& goal);
+		GateFinder(const FIntVector& start, const FIntVector& goal, ScratchArena& arena);
 		virtual ~GateFinder() = default;
 
 		void Entry(const FIntVector& start, const FIntVector& goal);
 
 		bool Pop(FIntVector& result);
 
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		// 門の検索で開いたノードと閉じたノードの数を統計に加算します
+		void AddStatistics(SearchStatistics& statistics) const noexcept;
+#endif
+
 	private:
-		std::vector<std::shared_ptr<const Gate>> mOpenGates;
-		std::vector<std::shared_ptr<const Gate>> mCloseGates;
+		using Gates = std::vector<Gate, ScratchAllocator<Gate>>;
+		using Visited = std::unordered_set<uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>, ScratchAllocator<uint64_t>>;
+
+		// 距離が同じならば先に登録したゲートを優先する最小ヒープ
+		Gates mOpenGates;
+		// 登録済みのゲート（OpenとCloseの両方）
+		Visited mVisited;
+		uint32_t mOrder = 0;
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		uint32_t mClosedCount = 0;
+#endif
 	};
 }
@@ -7,6 +7,8 @@ All Rights Reserved.
 */
 
 #pragma once
+#include "Core/AisleSearchMode.h"
+#include "Core/VoxelLayout.h"
 #include "Core/Math/Random.h"
 
 namespace dungeon
@@ -82,6 +84,41 @@ namespace dungeon
 		*/
 		Random& GetRandom() const noexcept { return const_cast<GenerateParameter*>(this)->mRandom; }
 
+		/**
+		通路を並列に探索するか？
+		*/
+		bool IsParallelAisleRouting() const noexcept { return mParallelAisleRouting; }
+
+		/**
+		通路を階層的に探索するか？
+		*/
+		bool IsHierarchicalAisleRouting() const noexcept { return mHierarchicalAisleRouting; }
+
+		/**
+		門の候補をキャッシュするか？
+		*/
+		bool IsCacheGateCandidates() const noexcept { return mCacheGateCandidates; }
+
+		/**
+		通路の探索方法
+		*/
+		AisleSearchMode GetAisleSearchMode() const noexcept { return mAisleSearchMode; }
+
+		/**
+		重み付きA*のヒューリスティックの重み
+		*/
+		float GetAisleHeuristicsWeight() const noexcept { return mAisleHeuristicsWeight; }
+
+		/**
+		ボクセルのメモリ配置
+		*/
+		VoxelLayout GetVoxelLayout() const noexcept { return mVoxelLayout; }
+
+		/**
+		通路の探索でボクセル毎に展開した回数を記録するか？
+		*/
+		bool IsAisleSearchHeatmap() const noexcept { return mAisleSearchHeatmap; }
+
 
 
 
@@ -170,6 +207,51 @@ namespace dungeon
 		*/
 		uint32_t mVerticalRoomMargin = 0;
 
+		/**
+		通路を並列に探索する
+		生成結果は直列に探索した場合と同じです。
+		*/
+		bool mParallelAisleRouting = false;
+
+		/**
+		通路を階層的（HPA*）に探索する
+		広いボクセル空間で長い通路の探索を高速化しますが、経路は最短とは限りません。
+		有効な場合はmParallelAisleRoutingを無視します。
+		*/
+		bool mHierarchicalAisleRouting = false;
+
+		/**
+		部屋の外周にある門の候補をキャッシュして門の検索を高速化する
+		選ばれる門の位置が変わるので、同じ乱数の種でも生成結果が変わります。
+		*/
+		bool mCacheGateCandidates = false;
+
+		/**
+		通路の探索方法
+		*/
+		AisleSearchMode mAisleSearchMode = AisleSearchMode::Standard;
+
+		/**
+		重み付きA*のヒューリスティックの重み
+		大きいほど展開するノードが減りますが、通路は長くなりやすくなります。
+		階段のコストはマンハッタン距離の変化より小さく、重みが1でもヒューリスティックが過大になるので、通路の長さに上限は保証されません。
+		*/
+		float mAisleHeuristicsWeight = 1.5f;
+
+		/**
+		ボクセルのメモリ配置
+		Tiledは上下前後の隣接グリッドの参照が速くなります。
+		Sparseは空白のグリッドだけの8x8x8のブリックを確保しないので、部屋が離れた広い空間のメモリを節約しますが、
+		グリッドの参照は少し遅くなります。
+		*/
+		VoxelLayout mVoxelLayout = VoxelLayout::Linear;
+
+		/**
+		通路の探索でボクセル毎に展開した回数を記録する
+		デバッグ表示用です。ボクセルと同じ数のカウンタを確保します。
+		*/
+		bool mAisleSearchHeatmap = false;
+
 		/**
 		乱数生成器
 		*/
@@ -8,9 +8,13 @@ All Rights Reserved.
 
 #include "Generator.h"
 #include "GenerateParameter.h"
+#include "ClusterGraph.h"
+#include "GateCandidateCache.h"
 #include "DelaunayTriangulation3D.h"
 #include "MinimumSpanningTree.h"
 #include "PathGoalCondition.h"
+#include "RouteCache.h"
+#include "SearchContext.h"
 #include "Voxel.h"
 #include "Debug/BuildInfomation.h"
 #include "Debug/Debug.h"
@@ -21,6 +25,7 @@ All Rights Reserved.
 #include "Math/Vector.h"
 
 #include "MissionGraph/MissionGraph.h"
+#include <Async/ParallelFor.h>
 
 #if WITH_EDITOR && JENKINS_FOR_DEVELOP
 #include <Misc/Paths.h>
@@ -33,6 +38,9 @@ All Rights Reserved.
 
 // 定義すると最終結果をBMPで出力します（デバッグ機能）
 //#define DEBUG_GENERATE_RESULT_BITMAP_FILE
+
+// 定義するとA*で展開した回数を階層毎にBMPで出力します（デバッグ機能）
+//#define DEBUG_GENERATE_SEARCH_HEATMAP_FILE
 #endif
 
 namespace dungeon
@@ -68,6 +76,10 @@ namespace dungeon
 		mStartPoint.reset();
 		mGoalPoint.reset();
 		mAisles.clear();
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		mSearchStatistics = SearchStatistics();
+		mSearchHeatmap.clear();
+#endif
 		mLastError = Generator::Error::Success;
 	}
 
@@ -829,72 +841,444 @@ namespace dungeon
 			}
 		);
 
+		// 門検索とA*の作業領域は全ての通路で共有する
+		SearchContext searchContext;
+		searchContext.SetSearchMode(parameter.GetAisleSearchMode(), parameter.GetAisleHeuristicsWeight());
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		if (parameter.IsAisleSearchHeatmap())
+			searchContext.EnableHeatmap(static_cast<size_t>(mVoxel->GetWidth()) * mVoxel->GetDepth() * mVoxel->GetHeight());
+#endif
+
+		// 部屋の外周にある門の候補
+		// 選ばれる門の位置が変わるので、有効にした場合だけ使う
+		std::unique_ptr<GateCandidateCache> gateCandidates;
+		if (parameter.IsCacheGateCandidates())
+		{
+			gateCandidates = std::make_unique<GateCandidateCache>(*mVoxel);
+			for (const auto& room : mRooms)
+				gateCandidates->Add(room->GetIdentifier(), room->GetRect(), room->GetBackground());
+			searchContext.SetGateCandidates(gateCandidates.get());
+		}
+
+		// 階層的経路探索の抽象グラフ
+		std::unique_ptr<ClusterGraph> clusterGraph;
+		if (parameter.IsHierarchicalAisleRouting())
+		{
+			clusterGraph = std::make_unique<ClusterGraph>(*mVoxel);
+			searchContext.SetClusterGraph(clusterGraph.get());
+		}
+
+		// 前回の生成で記録した経路
+		if (mRouteCache)
+			mRouteCache->Begin(*mVoxel, parameter.GetAisleSearchMode(), parameter.GetAisleHeuristicsWeight());
+
 		// 通路を生成
+		// 階層的経路探索は確定順に抽象グラフを更新するので並列探索と併用しない
+		const bool result = parameter.IsParallelAisleRouting() && !clusterGraph
+			? GenerateAisleVoxelInParallel(searchContext)
+			: GenerateAisleVoxel(searchContext);
+
+		if (mRouteCache)
+		{
+#if defined(DEBUG_SHOW_DEVELOP_LOG)
+			DUNGEON_GENERATOR_LOG(TEXT("再生した通路 %d / %d"), static_cast<int32_t>(mRouteCache->GetReplayedCount()), static_cast<int32_t>(mAisles.size()));
+#endif
+			mRouteCache->End();
+		}
+
+#if defined(DEBUG_SHOW_DEVELOP_LOG)
+		DUNGEON_GENERATOR_LOG(TEXT("経路探索の作業領域 %d blocks"), static_cast<int32_t>(searchContext.GetArena().GetBlockCount()));
+		DUNGEON_GENERATOR_LOG(TEXT("ボクセルの記憶領域 %d bytes"), static_cast<int32_t>(mVoxel->GetAllocatedSize()));
+#endif
+
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		mSearchStatistics = searchContext.GetTotalStatistics();
+		mSearchHeatmap = std::move(searchContext.GetHeatmap());
+		DUNGEON_GENERATOR_LOG(TEXT("経路探索: open %d, close %d, peak %d, stairs %d, rejected %d, gate open %d, gate close %d"),
+			static_cast<int32_t>(mSearchStatistics.mOpenedNodeCount),
+			static_cast<int32_t>(mSearchStatistics.mClosedNodeCount),
+			static_cast<int32_t>(mSearchStatistics.mPeakOpenNodeCount),
+			static_cast<int32_t>(mSearchStatistics.mStairProbeCount),
+			static_cast<int32_t>(mSearchStatistics.mRejectedReservationCount),
+			static_cast<int32_t>(mSearchStatistics.mGateOpenedNodeCount),
+			static_cast<int32_t>(mSearchStatistics.mGateClosedNodeCount)
+		);
+
+#if defined(DEBUG_GENERATE_SEARCH_HEATMAP_FILE)
+		GenerateSearchHeatmapImageForDebug();
+#endif
+#endif
+
+		return result;
+	}
+
+	bool Generator::GenerateAisleVoxel(SearchContext& searchContext) noexcept
+	{
+		Voxel::Route route;
 		for (const Aisle& aisle : mAisles)
 		{
-			std::shared_ptr<const Point> s = aisle.GetPoint(0);
-			std::shared_ptr<const Point> e = aisle.GetPoint(1);
+			FIntVector start, goal;
+			FIntRect goalRect;
+			GetAisleLocation(aisle, start, goal, goalRect);
+
+			if (!RouteAisle(route, aisle, start, goal, goalRect, searchContext))
+				return false;
+		}
+
+		return true;
+	}
+
+	bool Generator::GenerateAisleVoxelInParallel(SearchContext& searchContext) noexcept
+	{
+		/*
+		投機的な探索の結果
+		探索中に参照したボクセルを記録し、同じ窓で先に確定した通路が
+		そのボクセルを書き換えていなければ、直列に探索した場合と同じ結果になります。
+		*/
+		struct Speculation final
+		{
+			FIntVector mStart;
+			FIntVector mGoal;
+			FIntRect mGoalRect;
+			FIntVector mGate;
+			Voxel::Route mRoute;
+			std::vector<size_t> mReadIndices;
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+			SearchStatistics mStatistics;
+#endif
+			bool mSucceeded = false;
+		};
 
-			check(s->GetOwnerRoom()->GetRect().Contains(ToIntPoint(*s)));
-			check(e->GetOwnerRoom()->GetRect().Contains(ToIntPoint(*e)));
+		// タスクグラフのワーカーと呼び出し元のスレッドで探索する
+		const size_t workerCount = static_cast<size_t>(FTaskGraphInterface::Get().GetNumWorkerThreads()) + 1;
+		const size_t windowSize = workerCount * 2;
 
-			// Use the back room as a starting point.
-			if (s->GetOwnerRoom()->GetDepthFromStart() < e->GetOwnerRoom()->GetDepthFromStart())
+		std::vector<std::unique_ptr<SearchContext>> workerContexts;
+		workerContexts.reserve(workerCount);
+		for (size_t i = 0; i < workerCount; ++i)
+		{
+			workerContexts.emplace_back(std::make_unique<SearchContext>());
+			workerContexts.back()->SetSearchMode(searchContext.GetSearchMode(), searchContext.GetHeuristicsWeight());
+			workerContexts.back()->SetGateCandidates(searchContext.GetGateCandidates());
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+			if (!searchContext.GetHeatmap().empty())
+				workerContexts.back()->EnableHeatmap(searchContext.GetHeatmap().size());
+#endif
+		}
+
+		// 窓内で確定した通路が書き込んだボクセル
+		const size_t voxelCount = static_cast<size_t>(mVoxel->GetWidth()) * mVoxel->GetDepth() * mVoxel->GetHeight();
+		std::vector<uint32_t> claimed(voxelCount, 0);
+		uint32_t windowStamp = 0;
+
+		std::vector<Speculation> window(std::min(windowSize, mAisles.size()));
+		Voxel::Route route;
+
+		for (size_t windowBegin = 0; windowBegin < mAisles.size(); windowBegin += windowSize)
+		{
+			const size_t windowCount = std::min(windowSize, mAisles.size() - windowBegin);
+			++windowStamp;
+
+			for (size_t i = 0; i < windowCount; ++i)
 			{
-				const std::shared_ptr<const Point> t = e;
-				e = s;
-				s = t;
+				Speculation& speculation = window[i];
+				GetAisleLocation(mAisles[windowBegin + i], speculation.mStart, speculation.mGoal, speculation.mGoalRect);
 			}
 
-			check(s->GetOwnerRoom()->GetRect().Contains(ToIntPoint(*s)));
-			check(e->GetOwnerRoom()->GetRect().Contains(ToIntPoint(*e)));
+			// 確定前のボクセルに対して並列に探索する
+			// 作業領域はワーカー毎に一つなので、ワーカーの数だけタスクを作り、窓内の通路を順番に取り合う
+			std::atomic<size_t> nextIndex(0);
+			ParallelFor(static_cast<int32>(std::min(workerCount, windowCount)), [this, &window, &nextIndex, &workerContexts, windowBegin, windowCount](const int32 w)
+				{
+					SearchContext& context = *workerContexts[w];
+					for (size_t i = nextIndex++; i < windowCount; i = nextIndex++)
+					{
+						Speculation& speculation = window[i];
+						const Aisle& aisle = mAisles[windowBegin + i];
+						speculation.mReadIndices.clear();
+						speculation.mSucceeded = false;
+
+						// 記録した経路があれば確定時に再生するので探索しない
+						if (mRouteCache && mRouteCache->Contains({ speculation.mStart, speculation.mGoal, speculation.mGoalRect }))
+							continue;
+
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+						context.BeginAisleStatistics();
+#endif
 
-			const std::shared_ptr<Room>& startRoom = s->GetOwnerRoom();
-			const std::shared_ptr<Room>& goalRoom = e->GetOwnerRoom();
-			check(startRoom);
-			check(goalRoom);
-			
-			FIntVector start = ToIntVector(*s);
-			FIntVector goal = ToIntVector(*e);
+						context.BeginReadTracking(speculation.mReadIndices);
+						const PathGoalCondition goalCondition(speculation.mGoalRect);
+						if (mVoxel->SearchGateLocation(speculation.mGate, speculation.mStart, speculation.mGoal, goalCondition, aisle.GetIdentifier(), context))
+						{
+							speculation.mSucceeded = mVoxel->FindAisle(speculation.mRoute, speculation.mGate, speculation.mGoal, goalCondition, context);
+						}
+						context.EndReadTracking();
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+						speculation.mStatistics = context.GetAisleStatistics();
+#endif
+					}
+				}
+			);
 
-			// start周囲に侵入可能なグリッドを探す
-			FIntVector result;
-			if (mVoxel->SearchGateLocation(result, start, goal, PathGoalCondition(goalRoom->GetRect()), aisle.GetIdentifier()))
+			// 元の順番で確定する
+			for (size_t i = 0; i < windowCount; ++i)
 			{
-				start = result;
+				const Speculation& speculation = window[i];
+				const Aisle& aisle = mAisles[windowBegin + i];
+
+				const bool conflicted = std::any_of(speculation.mReadIndices.begin(), speculation.mReadIndices.end(), [&claimed, windowStamp](const size_t index)
+					{
+						return claimed[index] == windowStamp;
+					}
+				);
+
+				const Voxel::Route* committedRoute;
+				if (speculation.mSucceeded && !conflicted)
+				{
+					if (mRouteCache)
+					{
+						const RouteCache::Key routeKey{ speculation.mStart, speculation.mGoal, speculation.mGoalRect };
+						mRouteCache->Store(routeKey, speculation.mGate, speculation.mRoute, speculation.mReadIndices, *mVoxel, searchContext.GetGateCandidates());
+					}
+					mVoxel->WriteAisle(speculation.mRoute, aisle.GetIdentifier());
+					CommitAisle(speculation.mRoute, aisle, speculation.mGate, searchContext);
+					committedRoute = &speculation.mRoute;
+
+#if defined(DEBUG_SHOW_DEVELOP_LOG) && DUNGEON_GENERATOR_SEARCH_STATISTICS
+					LogAisleStatistics(aisle, speculation.mStatistics);
+#endif
+				}
+				else
+				{
+					// 失敗または先に確定した通路と衝突したので、直列と同じ手順で探索し直す
+					if (!RouteAisle(route, aisle, speculation.mStart, speculation.mGoal, speculation.mGoalRect, searchContext))
+						return false;
+					committedRoute = &route;
+				}
+
+				for (const Voxel::RouteNode& node : *committedRoute)
+					claimed[mVoxel->Index(node.mLocation)] = windowStamp;
 			}
-			else
+		}
+
+		// 投機的な探索で展開したノードも集計する
+		for (const auto& workerContext : workerContexts)
+		{
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+			searchContext.AddStatistics(workerContext->GetTotalStatistics());
+			std::vector<uint32_t>& heatmap = searchContext.GetHeatmap();
+			const std::vector<uint32_t>& workerHeatmap = workerContext->GetHeatmap();
+			for (size_t i = 0; i < std::min(heatmap.size(), workerHeatmap.size()); ++i)
+				heatmap[i] += workerHeatmap[i];
+#endif
+		}
+
+		return true;
+	}
+
+	void Generator::GetAisleLocation(const Aisle& aisle, FIntVector& start, FIntVector& goal, FIntRect& goalRect) const noexcept
+	{
+		std::shared_ptr<const Point> s = aisle.GetPoint(0);
+		std::shared_ptr<const Point> e = aisle.GetPoint(1);
+
+		check(s->GetOwnerRoom()->GetRect().Contains(ToIntPoint(*s)));
+		check(e->GetOwnerRoom()->GetRect().Contains(ToIntPoint(*e)));
+
+		// Use the back room as a starting point.
+		if (s->GetOwnerRoom()->GetDepthFromStart() < e->GetOwnerRoom()->GetDepthFromStart())
+		{
+			const std::shared_ptr<const Point> t = e;
+			e = s;
+			s = t;
+		}
+
+		check(s->GetOwnerRoom()->GetRect().Contains(ToIntPoint(*s)));
+		check(e->GetOwnerRoom()->GetRect().Contains(ToIntPoint(*e)));
+
+		const std::shared_ptr<Room>& startRoom = s->GetOwnerRoom();
+		const std::shared_ptr<Room>& goalRoom = e->GetOwnerRoom();
+		check(startRoom);
+		check(goalRoom);
+
+		start = ToIntVector(*s);
+		goal = ToIntVector(*e);
+		goalRect = goalRoom->GetRect();
+	}
+
+	bool Generator::RouteAisle(Voxel::Route& route, const Aisle& aisle, FIntVector start, const FIntVector& goal, const FIntRect& goalRect, SearchContext& searchContext) noexcept
+	{
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		searchContext.BeginAisleStatistics();
+#endif
+
+		// 抽象グラフの状態は参照したボクセルに含まれないので、階層的経路探索では経路を再利用しない
+		RouteCache* routeCache = searchContext.GetClusterGraph() ? nullptr : mRouteCache.get();
+		const RouteCache::Key routeKey{ start, goal, goalRect };
+
+		// 参照したボクセルが前回の生成と同じならば、記録した経路を再生する
+		if (routeCache)
+		{
+			FIntVector gate;
+			if (routeCache->Replay(route, gate, routeKey, *mVoxel, searchContext.GetGateCandidates()))
 			{
-				DUNGEON_GENERATOR_ERROR(TEXT("生成可能な門が見つからない (%d,%d,%d)-(%d,%d,%d)"), start.X, start.Y, start.Z, goal.X, goal.Y, goal.Z);
-				mLastError = Error::GateSearchFailed;
-				return false;
+				mVoxel->WriteAisle(route, aisle.GetIdentifier());
+				CommitAisle(route, aisle, gate, searchContext);
+				return true;
 			}
+		}
 
-			// Aisle generation by A*.
-			if (mVoxel->Aisle(start, goal, PathGoalCondition(goalRoom->GetRect()), aisle.GetIdentifier()))
+		std::vector<size_t> readIndices;
+		if (routeCache)
+			searchContext.BeginReadTracking(readIndices);
+
+		// start周囲に侵入可能なグリッドを探す
+		FIntVector result;
+		if (mVoxel->SearchGateLocation(result, start, goal, PathGoalCondition(goalRect), aisle.GetIdentifier(), searchContext))
+		{
+			start = result;
+		}
+		else
+		{
+			if (routeCache)
+				searchContext.EndReadTracking();
+			DUNGEON_GENERATOR_ERROR(TEXT("生成可能な門が見つからない (%d,%d,%d)-(%d,%d,%d)"), start.X, start.Y, start.Z, goal.X, goal.Y, goal.Z);
+			mLastError = Error::GateSearchFailed;
+			return false;
+		}
+
+		// Aisle generation by hierarchical A*.
+		bool routed = false;
+		const PathGoalCondition goalCondition(goalRect);
+		if (ClusterGraph* clusterGraph = searchContext.GetClusterGraph())
+		{
+			// 抽象グラフで選んだ回廊の中だけを詳細に探索する
+			if (clusterGraph->FindCorridor(start, goal, goalCondition))
 			{
-				Grid grid = mVoxel->Get(start.X, start.Y, start.Z);
-				check(grid.GetProps() == Grid::Props::None);
-				if (grid.GetProps() == Grid::Props::None)
+				searchContext.SetCorridor(clusterGraph);
+				routed = mVoxel->FindAisle(route, start, goal, goalCondition, searchContext);
+				searchContext.SetCorridor(nullptr);
+				if (routed)
+					mVoxel->WriteAisle(route, aisle.GetIdentifier());
+			}
+		}
+
+		// Aisle generation by A*.
+		if (!routed)
+		{
+			if (routeCache)
+			{
+				// 書き込む前のボクセルと一緒に経路を記録する
+				routed = mVoxel->FindAisle(route, start, goal, goalCondition, searchContext);
+				searchContext.EndReadTracking();
+				if (routed)
 				{
-					if (aisle.IsUniqueLocked())
-						grid.SetProps(Grid::Props::UniqueLock);
-					else if (aisle.IsLocked())
-						grid.SetProps(Grid::Props::Lock);
+					routeCache->Store(routeKey, start, route, readIndices, *mVoxel, searchContext.GetGateCandidates());
+					mVoxel->WriteAisle(route, aisle.GetIdentifier());
 				}
-				mVoxel->Set(start.X, start.Y, start.Z, grid);
 			}
 			else
 			{
-				DUNGEON_GENERATOR_ERROR(TEXT("経路探索に失敗しました (%d,%d,%d)-(%d,%d,%d)"), start.X, start.Y, start.Z, goal.X, goal.Y, goal.Z);
-				mLastError = Error::RouteSearchFailed;
-				return false;
+				routed = mVoxel->Aisle(route, start, goal, goalCondition, aisle.GetIdentifier(), searchContext);
 			}
 		}
 
+		if (routed)
+		{
+			CommitAisle(route, aisle, start, searchContext);
+
+#if defined(DEBUG_SHOW_DEVELOP_LOG) && DUNGEON_GENERATOR_SEARCH_STATISTICS
+			LogAisleStatistics(aisle, searchContext.GetAisleStatistics());
+#endif
+		}
+		else
+		{
+			DUNGEON_GENERATOR_ERROR(TEXT("経路探索に失敗しました (%d,%d,%d)-(%d,%d,%d)"), start.X, start.Y, start.Z, goal.X, goal.Y, goal.Z);
+			mLastError = Error::RouteSearchFailed;
+			return false;
+		}
+
 		return true;
 	}
 
+	void Generator::CommitAisle(const Voxel::Route& route, const Aisle& aisle, const FIntVector& gate, SearchContext& searchContext) noexcept
+	{
+		LockGate(aisle, gate);
+
+		if (ClusterGraph* clusterGraph = searchContext.GetClusterGraph())
+			clusterGraph->Update(route);
+
+		if (GateCandidateCache* gateCandidates = searchContext.GetGateCandidates())
+			gateCandidates->Update(route);
+	}
+
+	void Generator::LockGate(const Aisle& aisle, const FIntVector& location) noexcept
+	{
+		Grid grid = mVoxel->Get(location.X, location.Y, location.Z);
+		check(grid.GetProps() == Grid::Props::None);
+		if (grid.GetProps() == Grid::Props::None)
+		{
+			if (aisle.IsUniqueLocked())
+				grid.SetProps(Grid::Props::UniqueLock);
+			else if (aisle.IsLocked())
+				grid.SetProps(Grid::Props::Lock);
+		}
+		mVoxel->Set(location.X, location.Y, location.Z, grid);
+	}
+
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+	void Generator::LogAisleStatistics(const Aisle& aisle, const SearchStatistics& statistics) noexcept
+	{
+		DUNGEON_GENERATOR_LOG(TEXT("通路 %d: open %d, close %d, peak %d, stairs %d, rejected %d, gate open %d, gate close %d"),
+			static_cast<int32_t>(aisle.GetIdentifier().Get()),
+			static_cast<int32_t>(statistics.mOpenedNodeCount),
+			static_cast<int32_t>(statistics.mClosedNodeCount),
+			static_cast<int32_t>(statistics.mPeakOpenNodeCount),
+			static_cast<int32_t>(statistics.mStairProbeCount),
+			static_cast<int32_t>(statistics.mRejectedReservationCount),
+			static_cast<int32_t>(statistics.mGateOpenedNodeCount),
+			static_cast<int32_t>(statistics.mGateClosedNodeCount)
+		);
+	}
+
+	void Generator::GenerateSearchHeatmapImageForDebug() const
+	{
+#if defined(DEBUG_GENERATE_SEARCH_HEATMAP_FILE)
+		if (mSearchHeatmap.empty())
+			return;
+
+		const uint32_t maxCount = *std::max_element(mSearchHeatmap.begin(), mSearchHeatmap.end());
+		if (maxCount == 0)
+			return;
+
+		static const bmp::RGBCOLOR coldColor = { 64, 0, 0 };
+		static const bmp::RGBCOLOR hotColor = { 0, 255, 255 };
+		for (uint32_t z = 0; z < mVoxel->GetHeight(); ++z)
+		{
+			bmp::Canvas canvas(mVoxel->GetWidth(), mVoxel->GetDepth());
+			for (uint32_t y = 0; y < mVoxel->GetDepth(); ++y)
+			{
+				for (uint32_t x = 0; x < mVoxel->GetWidth(); ++x)
+				{
+					const uint32_t count = mSearchHeatmap[mVoxel->Index(x, y, z)];
+					bmp::RGBCOLOR color = { 0, 0, 0 };
+					if (count > 0)
+					{
+						const float ratio = static_cast<float>(count) / static_cast<float>(maxCount);
+						color.rgbRed = coldColor.rgbRed + (hotColor.rgbRed - coldColor.rgbRed) * ratio;
+						color.rgbGreen = coldColor.rgbGreen + (hotColor.rgbGreen - coldColor.rgbGreen) * ratio;
+						color.rgbBlue = coldColor.rgbBlue + (hotColor.rgbBlue - coldColor.rgbBlue) * ratio;
+					}
+					canvas.Put(x, y, color);
+				}
+			}
+
+			const FString path = FPaths::ProjectSavedDir() + FString::Printf(TEXT("/DungeonGenerator/search_heatmap_%d.bmp"), z);
+			canvas.Write(TCHAR_TO_UTF8(*path));
+		}
+#endif
+	}
+#endif
+
 	void Generator::GenerateRoomImageForDebug(const std::string& filename) const
 	{
 #if defined(DEBUG_GENERATE_BITMAP_FILE)
@@ -1100,7 +1484,7 @@ namespace dungeon
 	}
 
 
-	const Grid& Generator::GetGrid(const FIntVector& location) const noexcept
+	Grid Generator::GetGrid(const FIntVector& location) const noexcept
 	{
 		return mVoxel->Get(location.X, location.Y, location.Z);
 	}
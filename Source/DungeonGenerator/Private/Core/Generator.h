@@ -10,6 +10,8 @@ All Rights Reserved.
 #include "Aisle.h"
 #include "GenerateParameter.h"
 #include "Room.h"
+#include "SearchStatistics.h"
+#include "Voxel.h"
 #include <atomic>
 #include <functional>
 #include <future>
@@ -25,7 +27,8 @@ namespace dungeon
 	// 前方宣言
 	class Grid;
 	class MinimumSpanningTree;
-	class Voxel;
+	class RouteCache;
+	class SearchContext;
 
 	/**
 	ダンジョン生成クラス
@@ -65,6 +68,13 @@ namespace dungeon
 		*/
 		void Generate(const GenerateParameter& parameter) noexcept;
 
+		/**
+		通路の経路キャッシュを設定します
+		再生成で同じ通路を探索する時に、記録した経路を再生します
+		\param[in]	routeCache	通路の経路キャッシュ（nullptrなら常に探索する）
+		*/
+		void SetRouteCache(const std::shared_ptr<RouteCache>& routeCache) noexcept;
+
 		/**
 		生成時に発生したエラーを取得します
 		*/
@@ -80,7 +90,21 @@ namespace dungeon
 		*/
 		const std::shared_ptr<Voxel>& GetVoxel() const noexcept;
 
-		const Grid& GetGrid(const FIntVector& location) const noexcept;
+		Grid GetGrid(const FIntVector& location) const noexcept;
+
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		/**
+		直前の生成の経路探索の統計を取得します
+		*/
+		const SearchStatistics& GetSearchStatistics() const noexcept;
+
+		/**
+		直前の生成でボクセル毎にA*で展開した回数を取得します
+		並列探索では、確定しなかった投機的な探索で展開した回数も含みます
+		\return	Voxel::Indexで参照する配列
+		*/
+		const std::vector<uint32_t>& GetSearchHeatmap() const noexcept;
+#endif
 
 		////////////////////////////////////////////////////////////////////////////////////////////
 		// Room
@@ -88,8 +112,10 @@ namespace dungeon
 
 		/**
 		生成された部屋を更新します
+		\param[in]	func	void(const std::shared_ptr<Room>&)
 		*/
-		void ForEach(std::function<void(const std::shared_ptr<Room>&)> func) noexcept
+		template<typename Function>
+		void ForEach(Function&& func) noexcept
 		{
 			for (const auto& room : mRooms)
 			{
@@ -99,15 +125,25 @@ namespace dungeon
 
 		/**
 		生成された部屋を参照します
+		\param[in]	func	void(const Room&)
 		*/
-		void ForEach(std::function<void(const std::shared_ptr<const Room>&)> func) const noexcept
+		template<typename Function>
+		void ForEach(Function&& func) const noexcept
 		{
 			for (const auto& room : mRooms)
 			{
-				func(room);
+				func(static_cast<const Room&>(*room));
 			}
 		}
 
+		/**
+		生成された部屋のコンテナを取得します
+		*/
+		const std::list<std::shared_ptr<Room>>& GetRooms() const noexcept
+		{
+			return mRooms;
+		}
+
 		// 深度による検索
 		std::vector<std::shared_ptr<Room>> FindByDepth(const uint8_t depth) const noexcept;
 
@@ -133,7 +169,8 @@ namespace dungeon
 	public:
 		////////////////////////////////////////////////////////////////////////////////////////////
 		// Aisle
-		void EachAisle(std::function<void(const Aisle& edge)> func) const noexcept
+		template<typename Function>
+		void EachAisle(Function&& func) const noexcept
 		{
 			for (const auto& aisle : mAisles)
 			{
@@ -141,8 +178,17 @@ namespace dungeon
 			}
 		}
 
+		/**
+		生成された通路のコンテナを取得します
+		*/
+		const std::vector<Aisle>& GetAisles() const noexcept
+		{
+			return mAisles;
+		}
+
 		// 部屋に接続している通路を検索
-		void FindAisle(const std::shared_ptr<const Room>& room, std::function<bool(Aisle& edge)> func) noexcept
+		template<typename Function>
+		void FindAisle(const std::shared_ptr<const Room>& room, Function&& func) noexcept
 		{
 			for (auto& aisle : mAisles)
 			{
@@ -156,7 +202,8 @@ namespace dungeon
 			}
 		} 
 
-		void FindAisle(const std::shared_ptr<const Room>& room, std::function<bool(const Aisle& edge)> func) const noexcept
+		template<typename Function>
+		void FindAisle(const std::shared_ptr<const Room>& room, Function&& func) const noexcept
 		{
 			for (const auto& aisle : mAisles)
 			{
@@ -216,7 +263,8 @@ namespace dungeon
 		行き止まりの点を更新します
 		\param[in]	func	点を元に更新する関数
 		*/
-		void EachLeafPoint(std::function<void(const std::shared_ptr<const Point>& point)> func) const noexcept
+		template<typename Function>
+		void EachLeafPoint(Function&& func) const noexcept
 		{
 			for (auto& point : mLeafPoints)
 			{
@@ -289,6 +337,59 @@ namespace dungeon
 		*/
 		bool GenerateAisle(const MinimumSpanningTree& minimumSpanningTree) noexcept;
 
+		/**
+		通路をボクセルに書き込みます
+		\param[in]	searchContext	経路探索コンテキスト
+		\return		falseならば通路の生成に失敗
+		*/
+		bool GenerateAisleVoxel(SearchContext& searchContext) noexcept;
+
+		/**
+		通路をボクセルに書き込みます
+		窓内の通路を並列に投機的に探索し、元の順番で確定します。
+		結果はGenerateAisleVoxelと一致します。
+		\param[in]	searchContext	経路探索コンテキスト
+		\return		falseならば通路の生成に失敗
+		*/
+		bool GenerateAisleVoxelInParallel(SearchContext& searchContext) noexcept;
+
+		/**
+		通路の始点と終点を取得します
+		\param[in]		aisle		通路
+		\param[out]	start		始点
+		\param[out]	goal		終点
+		\param[out]	goalRect	終点の部屋の範囲
+		*/
+		void GetAisleLocation(const Aisle& aisle, FIntVector& start, FIntVector& goal, FIntRect& goalRect) const noexcept;
+
+		/**
+		門を探してから通路を探索し、ボクセルに書き込みます
+		\param[out]	route			書き込んだ経路
+		\param[in]		aisle			通路
+		\param[in]		start			始点
+		\param[in]		goal			終点
+		\param[in]		goalRect		終点の部屋の範囲
+		\param[in]		searchContext	経路探索コンテキスト
+		\return		falseならば通路の生成に失敗
+		*/
+		bool RouteAisle(Voxel::Route& route, const Aisle& aisle, FIntVector start, const FIntVector& goal, const FIntRect& goalRect, SearchContext& searchContext) noexcept;
+
+		/**
+		ボクセルに書き込んだ通路を確定します
+		\param[in]	route			書き込んだ経路
+		\param[in]	aisle			通路
+		\param[in]	gate			門の位置
+		\param[in]	searchContext	経路探索コンテキスト
+		*/
+		void CommitAisle(const Voxel::Route& route, const Aisle& aisle, const FIntVector& gate, SearchContext& searchContext) noexcept;
+
+		/**
+		通路の施錠状態を門に書き込みます
+		\param[in]	aisle		通路
+		\param[in]	location	門の位置
+		*/
+		void LockGate(const Aisle& aisle, const FIntVector& location) noexcept;
+
 		/**
 		幅と奥行きを指定した中心から方向ベクターが指す接点までの距離を計算します
 		\param[in]		width		矩形の幅
@@ -308,10 +409,27 @@ namespace dungeon
 		*/
 		void GenerateRoomImageForDebug(const std::string& filename) const;
 
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		/*
+		通路毎の経路探索の統計をログに出力します
+		*/
+		static void LogAisleStatistics(const Aisle& aisle, const SearchStatistics& statistics) noexcept;
+
+		/*
+		デバッグ用にA*で展開した回数を階層毎に画像に出力します
+		*/
+		void GenerateSearchHeatmapImageForDebug() const;
+#endif
+
 	private:
 		GenerateParameter mGenerateParameter;
 
 		std::shared_ptr<Voxel> mVoxel;
+		std::shared_ptr<RouteCache> mRouteCache;
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		SearchStatistics mSearchStatistics;
+		std::vector<uint32_t> mSearchHeatmap;
+#endif
 		std::list<std::shared_ptr<Room>> mRooms;
 
 		std::vector<int32_t> mFloorHeight;
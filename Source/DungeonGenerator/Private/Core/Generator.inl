@@ -10,8 +10,25 @@ All Rights Reserved.
 
 namespace dungeon
 {
+	inline void Generator::SetRouteCache(const std::shared_ptr<RouteCache>& routeCache) noexcept
+	{
+		mRouteCache = routeCache;
+	}
+
 	inline Generator::Error Generator::GetLastError() const noexcept
 	{
 		return mLastError;
 	}
+
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+	inline const SearchStatistics& Generator::GetSearchStatistics() const noexcept
+	{
+		return mSearchStatistics;
+	}
+
+	inline const std::vector<uint32_t>& Generator::GetSearchHeatmap() const noexcept
+	{
+		return mSearchHeatmap;
+	}
+#endif
 }
@@ -9,7 +9,7 @@ All Rights Reserved.
 #pragma once
 #include "Core/Math/Random.h"
 #include "Direction.h"
-#include <bitset>
+#include <cstdint>
 
 namespace dungeon
 {
@@ -78,6 +78,16 @@ namespace dungeon
 		*/
 		~Grid() = default;
 
+		/**
+		全ての情報が同じグリッドか判定します
+		*/
+		bool operator==(const Grid& other) const noexcept;
+
+		/**
+		情報が異なるグリッドか判定します
+		*/
+		bool operator!=(const Grid& other) const noexcept;
+
 		/**
 		グリッドの種類を取得します
 		*/
@@ -280,20 +290,47 @@ namespace dungeon
 		const FString& GetPropsName() const noexcept;
 
 	private:
-		static constexpr uint16_t InvalidIdentifier = static_cast<uint16_t>(~0);
+		/**
+		自身とtoGridの種類からGridRuleTableのインデックスを取得します
+		*/
+		size_t RuleIndex(const Grid& toGrid) const noexcept;
 
-		Type mType;
-		Props mProps;
-		Direction mDirection;
-		uint16_t mIdentifier = InvalidIdentifier;
+		/**
+		GridRuleTableの壁の条件のビット位置を取得します
+		*/
+		uint32_t WallCondition(const Grid& toGrid, const Direction::Index direction, const bool mergeRooms) const noexcept;
 
-		enum class NoMeshGeneration : uint8_t
-		{
-			Floor,
-			Roof
-		};
-		std::bitset<2> mNoMeshGeneration = 0;
+	private:
+		static constexpr uint16_t InvalidIdentifier = static_cast<uint16_t>(~0);
+
+		/*
+		全ての情報を32ビットに詰めて保持します
+		bit 0-2		種類
+		bit 3-4		小道具
+		bit 5-6		方向
+		bit 7		床のメッシュ生成禁止
+		bit 8		天井のメッシュ生成禁止
+		bit 16-31	識別子
+		*/
+		static constexpr uint32_t TypeShift = 0;
+		static constexpr uint32_t TypeMask = 0x7u << TypeShift;
+		static constexpr uint32_t PropsShift = 3;
+		static constexpr uint32_t PropsMask = 0x3u << PropsShift;
+		static constexpr uint32_t DirectionShift = 5;
+		static constexpr uint32_t DirectionMask = 0x3u << DirectionShift;
+		static constexpr uint32_t NoFloorMeshGenerationBit = 1u << 7;
+		static constexpr uint32_t NoRoofMeshGenerationBit = 1u << 8;
+		static constexpr uint32_t IdentifierShift = 16;
+		static constexpr uint32_t IdentifierMask = 0xFFFFu << IdentifierShift;
+
+		static_assert(TypeSize <= (TypeMask >> TypeShift) + 1, "Grid::Type does not fit in the packed bits");
+		static_assert(PropsSize <= (PropsMask >> PropsShift) + 1, "Grid::Props does not fit in the packed bits");
+
+		static constexpr uint32_t Pack(const Type type, const Direction::Index direction, const uint16_t identifier) noexcept;
+
+		uint32_t mPacked;
 	};
+	static_assert(sizeof(Grid) == sizeof(uint32_t), "Grid must be packed into 32 bits");
 }
 
 #include "Grid.inl"
@@ -9,35 +9,36 @@ All Rights Reserved.
 #pragma once
 #include "Core/Math/Random.h"
 #include "Direction.h"
+#include "GridRuleTable.h"
 
 namespace dungeon
 {
+	inline constexpr uint32_t Grid::Pack(const Type type, const Direction::Index direction, const uint16_t identifier) noexcept
+	{
+		return
+			((static_cast<uint32_t>(type) << TypeShift) & TypeMask) |
+			(static_cast<uint32_t>(Props::None) << PropsShift) |
+			((static_cast<uint32_t>(direction) << DirectionShift) & DirectionMask) |
+			(static_cast<uint32_t>(identifier) << IdentifierShift);
+	}
+
 	inline Grid::Grid() noexcept
-		: mType(Type::Empty)
-		, mProps(Props::None)
-		, mDirection(Direction(Direction::North))
+		: mPacked(Pack(Type::Empty, Direction::North, InvalidIdentifier))
 	{
 	}
 
 	inline Grid::Grid(const Type type) noexcept
-		: mType(type)
-		, mProps(Props::None)
-		, mDirection(Direction(Direction::North))
+		: mPacked(Pack(type, Direction::North, InvalidIdentifier))
 	{
 	}
 
 	inline Grid::Grid(const Type type, const Direction direction) noexcept
-		: mType(type)
-		, mProps(Props::None)
-		, mDirection(direction)
+		: mPacked(Pack(type, direction.Get(), InvalidIdentifier))
 	{
 	}
 
 	inline Grid::Grid(const Type type, const Direction direction, const uint16_t identifier) noexcept
-		: mType(type)
-		, mProps(Props::None)
-		, mDirection(direction)
-		, mIdentifier(identifier)
+		: mPacked(Pack(type, direction.Get(), identifier))
 	{
 	}
 
@@ -51,64 +52,140 @@ namespace dungeon
 		return Grid(Type::Deck, Direction::CreateFromRandom(random), identifier);
 	}
 
+	inline bool Grid::operator==(const Grid& other) const noexcept
+	{
+		return mPacked == other.mPacked;
+	}
+
+	inline bool Grid::operator!=(const Grid& other) const noexcept
+	{
+		return mPacked != other.mPacked;
+	}
+
 	inline Grid::Type Grid::GetType() const noexcept
 	{
-		return mType;
+		return static_cast<Type>((mPacked & TypeMask) >> TypeShift);
 	}
 
 	inline void Grid::SetType(const Type type) noexcept
 	{
-		mType = type;
+		mPacked = (mPacked & ~TypeMask) | ((static_cast<uint32_t>(type) << TypeShift) & TypeMask);
 	}
 
 	inline Direction Grid::GetDirection() const noexcept
 	{
-		return mDirection;
+		return Direction(static_cast<Direction::Index>((mPacked & DirectionMask) >> DirectionShift));
 	}
 
 	inline void Grid::SetDirection(const Direction direction) noexcept
 	{
-		mDirection = direction;
+		mPacked = (mPacked & ~DirectionMask) | ((static_cast<uint32_t>(direction.Get()) << DirectionShift) & DirectionMask);
 	}
 
 	inline uint16_t Grid::GetIdentifier() const noexcept
 	{
-		return mIdentifier;
+		return static_cast<uint16_t>(mPacked >> IdentifierShift);
 	}
 
 	inline void Grid::SetIdentifier(const uint16_t identifier) noexcept
 	{
-		mIdentifier = identifier;
+		mPacked = (mPacked & ~IdentifierMask) | (static_cast<uint32_t>(identifier) << IdentifierShift);
 	}
 
 	inline bool Grid::IsInvalidIdentifier() const noexcept
 	{
-		return mIdentifier == InvalidIdentifier;
+		return GetIdentifier() == InvalidIdentifier;
 	}
 
 	inline Grid::Props Grid::GetProps() const noexcept
 	{
-		return mProps;
+		return static_cast<Props>((mPacked & PropsMask) >> PropsShift);
 	}
 
 	inline void Grid::SetProps(const Props props) noexcept
 	{
-		mProps = props;
+		mPacked = (mPacked & ~PropsMask) | ((static_cast<uint32_t>(props) << PropsShift) & PropsMask);
 	}
 
 	inline void Grid::SetNoMeshGeneration(const bool noRoofMeshGeneration, const bool noFloorMeshGeneration)
 	{
-		mNoMeshGeneration.set(static_cast<uint8_t>(NoMeshGeneration::Roof), noRoofMeshGeneration);
-		mNoMeshGeneration.set(static_cast<uint8_t>(NoMeshGeneration::Floor), noFloorMeshGeneration);
+		mPacked &= ~(NoRoofMeshGenerationBit | NoFloorMeshGenerationBit);
+		if (noRoofMeshGeneration)
+			mPacked |= NoRoofMeshGenerationBit;
+		if (noFloorMeshGeneration)
+			mPacked |= NoFloorMeshGenerationBit;
 	}
 
 	inline bool Grid::IsNoFloorMeshGeneration() const noexcept
 	{
-		return mNoMeshGeneration.test(static_cast<uint8_t>(NoMeshGeneration::Floor));
+		return (mPacked & NoFloorMeshGenerationBit) != 0;
 	}
 
 	inline bool Grid::IsNoRoofMeshGeneration() const noexcept
 	{
-		return mNoMeshGeneration.test(static_cast<uint8_t>(NoMeshGeneration::Roof));
+		return (mPacked & NoRoofMeshGenerationBit) != 0;
+	}
+
+	// 判定の表はGrid::Typeの値で参照するので並びを確認します
+	static_assert(GridRuleTable::TypeSize == Grid::TypeSize, "GridRuleTable must cover every Grid::Type");
+	static_assert(static_cast<uint8_t>(Grid::Type::Gate) == GridRuleTable::Gate, "GridRuleTable must follow Grid::Type");
+	static_assert(static_cast<uint8_t>(Grid::Type::Atrium) == GridRuleTable::Atrium, "GridRuleTable must follow Grid::Type");
+	static_assert(static_cast<uint8_t>(Grid::Type::OutOfBounds) == GridRuleTable::OutOfBounds, "GridRuleTable must follow Grid::Type");
+
+	inline size_t Grid::RuleIndex(const Grid& toGrid) const noexcept
+	{
+		return GridRuleTable::Index(static_cast<uint8_t>(GetType()), static_cast<uint8_t>(toGrid.GetType()));
+	}
+
+	inline bool Grid::CanBuildFloor(const Grid& toGrid, const bool checkNoMeshGeneration) const noexcept
+	{
+		const uint32_t sameIdentifier = ((mPacked ^ toGrid.mPacked) & IdentifierMask) == 0;
+		const uint32_t noMeshGeneration = checkNoMeshGeneration & ((mPacked & NoFloorMeshGenerationBit) != 0);
+		return ((GridRuleTable::FloorTable[RuleIndex(toGrid)] >> sameIdentifier) & ~noMeshGeneration & 1) != 0;
+	}
+
+	inline bool Grid::CanBuildRoof(const Grid& toGrid, const bool checkNoMeshGeneration) const noexcept
+	{
+		const uint32_t noMeshGeneration = checkNoMeshGeneration & ((mPacked & NoRoofMeshGenerationBit) != 0);
+		return ((GridRuleTable::RoofTable >> RuleIndex(toGrid)) & ~noMeshGeneration & 1) != 0;
+	}
+
+	inline uint32_t Grid::WallCondition(const Grid& toGrid, const Direction::Index direction, const bool mergeRooms) const noexcept
+	{
+		const uint32_t selfDirection = (mPacked & DirectionMask) >> DirectionShift;
+		const uint32_t toDirection = (toGrid.mPacked & DirectionMask) >> DirectionShift;
+		const uint32_t sameIdentifier = ((mPacked ^ toGrid.mPacked) & IdentifierMask) == 0;
+		return
+			sameIdentifier |
+			(((selfDirection ^ direction) & 1) << 1) |
+			(((toDirection ^ direction) & 1) << 2) |
+			(static_cast<uint32_t>(mergeRooms) << 3);
+	}
+
+	inline bool Grid::CanBuildWall(const Grid& toGrid, const Direction::Index direction, const bool mergeRooms) const noexcept
+	{
+		return ((GridRuleTable::WallTable[RuleIndex(toGrid)] >> WallCondition(toGrid, direction, mergeRooms)) & 1) != 0;
+	}
+
+	inline bool Grid::CanBuildWallForMinimap(const Grid& toGrid, const Direction::Index direction, const bool mergeRooms) const noexcept
+	{
+		return ((GridRuleTable::WallForMinimapTable[RuleIndex(toGrid)] >> WallCondition(toGrid, direction, mergeRooms)) & 1) != 0;
+	}
+
+	inline bool Grid::CanBuildPillar(const Grid& toGrid) const noexcept
+	{
+		return ((GridRuleTable::PillarTable >> static_cast<uint8_t>(toGrid.GetType())) & 1) != 0;
+	}
+
+	inline bool Grid::CanBuildGate(const Grid& toGrid, const Direction::Index direction) const noexcept
+	{
+		const uint32_t selfDirection = (mPacked & DirectionMask) >> DirectionShift;
+		const uint32_t toDirection = (toGrid.mPacked & DirectionMask) >> DirectionShift;
+		const uint32_t condition =
+			static_cast<uint32_t>(selfDirection == toDirection) |
+			(static_cast<uint32_t>(((selfDirection + 2) & 3) == static_cast<uint32_t>(direction)) << 1) |
+			(static_cast<uint32_t>(((selfDirection ^ toDirection) & 1) == 0) << 2) |
+			(static_cast<uint32_t>(((selfDirection ^ direction) & 1) == 0) << 3);
+		return ((GridRuleTable::GateTable[RuleIndex(toGrid)] >> condition) & 1) != 0;
 	}
 }
@@ -0,0 +1,369 @@
+/**
+グリッドのメッシュ生成規則の表 ヘッダーファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace dungeon
+{
+	/**
+	グリッドのメッシュ生成規則の表クラス
+	Grid::CanBuild系の判定を、自身と参照先の種類の組み合わせ毎にコンパイル時に評価して表にします。
+	識別子や方向に依存する条件は表の要素内のビット位置で区別するので、
+	判定は表の参照とビットの取り出しだけで分岐しません。
+	種類はGrid::Typeの値をそのまま使います。
+	*/
+	class GridRuleTable final
+	{
+	public:
+		//! 種類の数（Grid::TypeSizeと一致させて下さい）
+		static constexpr size_t TypeSize = 8;
+
+		/**
+		種類の値
+		Grid::Typeと同じ並びにして下さい
+		*/
+		enum TypeValue : uint8_t
+		{
+			Floor,
+			Deck,
+			Gate,
+			Aisle,
+			Slope,
+			Atrium,
+			Empty,
+			OutOfBounds
+		};
+
+		/*
+		壁の条件のビット
+		bit 0	識別子が一致
+		bit 1	自身の方向の軸と参照先への方向の軸が交差
+		bit 2	参照先の方向の軸と参照先への方向の軸が交差
+		bit 3	部屋と部屋を結合する
+		*/
+		static constexpr uint8_t WallSameIdentifier = 1 << 0;
+		static constexpr uint8_t WallSelfCrossed = 1 << 1;
+		static constexpr uint8_t WallToCrossed = 1 << 2;
+		static constexpr uint8_t WallMergeRooms = 1 << 3;
+
+		/*
+		扉の条件のビット
+		bit 0	自身と参照先の方向が一致
+		bit 1	自身の逆方向が参照先への方向と一致
+		bit 2	自身と参照先の方向の軸が一致
+		bit 3	自身の方向の軸と参照先への方向の軸が一致
+		*/
+		static constexpr uint8_t GateSameDirection = 1 << 0;
+		static constexpr uint8_t GateInverseDirection = 1 << 1;
+		static constexpr uint8_t GateSameAxis = 1 << 2;
+		static constexpr uint8_t GateSameAxisAsDirection = 1 << 3;
+
+		//! 床の条件のビット（識別子が一致）
+		static constexpr uint8_t FloorSameIdentifier = 1 << 0;
+
+		/**
+		自身と参照先の種類から表のインデックスを取得します
+		*/
+		static constexpr size_t Index(const uint8_t self, const uint8_t to) noexcept
+		{
+			return static_cast<size_t>(self) * TypeSize + to;
+		}
+
+	private:
+		static constexpr bool IsKindOfRoomType(const uint8_t type) noexcept
+		{
+			return type == Floor || type == Deck || type == Gate;
+		}
+
+		static constexpr bool IsKindOfRoomTypeWithoutGate(const uint8_t type) noexcept
+		{
+			return type == Floor || type == Deck;
+		}
+
+		static constexpr bool IsKindOfAisleType(const uint8_t type) noexcept
+		{
+			return type == Aisle;
+		}
+
+		static constexpr bool IsKindOfSlopeType(const uint8_t type) noexcept
+		{
+			return type == Slope || type == Atrium;
+		}
+
+		static constexpr bool IsKindOfSpatialType(const uint8_t type) noexcept
+		{
+			return type == Empty || type == OutOfBounds;
+		}
+
+		static constexpr bool IsHorizontallyPassable(const uint8_t type) noexcept
+		{
+			return IsKindOfRoomType(type) || type == Aisle || IsKindOfSlopeType(type);
+		}
+
+		/*
+		自身からtoを見た時に床が生成されるか判定します
+		*/
+		static constexpr bool FloorRule(const uint8_t self, const uint8_t to, const uint8_t condition) noexcept
+		{
+			const bool differentIdentifier = (condition & FloorSameIdentifier) == 0;
+			if (IsKindOfRoomType(self))
+			{
+				return
+					differentIdentifier ||
+					IsKindOfAisleType(to) ||
+					IsKindOfSlopeType(to) ||
+					IsKindOfSpatialType(to);
+			}
+			else if (IsKindOfAisleType(self))
+			{
+				return
+					differentIdentifier ||
+					IsKindOfRoomType(to) ||
+					IsKindOfAisleType(to) ||
+					IsKindOfSlopeType(to) ||
+					IsKindOfSpatialType(to);
+			}
+			return false;
+		}
+
+		/*
+		自身からtoを見た時に屋根が生成されるか判定します
+		*/
+		static constexpr bool RoofRule(const uint8_t self, const uint8_t to) noexcept
+		{
+			if (IsKindOfRoomType(self))
+			{
+				return
+					(to == Deck || to == Gate) ||
+					IsKindOfAisleType(to) ||
+					IsKindOfSlopeType(to) ||
+					IsKindOfSpatialType(to);
+			}
+			else if (IsKindOfAisleType(self))
+			{
+				return
+					IsKindOfRoomType(to) ||
+					IsKindOfAisleType(to) ||
+					IsKindOfSlopeType(to) ||
+					IsKindOfSpatialType(to);
+			}
+			else if (IsKindOfSlopeType(self))
+			{
+				return
+					IsKindOfRoomType(to) ||
+					IsKindOfAisleType(to) ||
+					to == Slope ||
+					IsKindOfSpatialType(to);
+			}
+			return false;
+		}
+
+		/*
+		自身からtoを見た時に壁が生成されるか判定します
+		minimapがtrueならば部屋から斜面への壁を生成しません
+		*/
+		static constexpr bool WallRule(const uint8_t self, const uint8_t to, const uint8_t condition, const bool minimap) noexcept
+		{
+			const bool differentIdentifier = (condition & WallSameIdentifier) == 0;
+			const bool selfCrossed = (condition & WallSelfCrossed) != 0;
+			const bool toCrossed = (condition & WallToCrossed) != 0;
+			const bool mergeRooms = (condition & WallMergeRooms) != 0;
+
+			// 部屋と部屋が隣接している場合、識別子が不一致なら壁がある
+			if (!mergeRooms && IsKindOfRoomTypeWithoutGate(self) && IsKindOfRoomTypeWithoutGate(to))
+				return differentIdentifier;
+
+			if (self == Gate)
+			{
+				// 識別子が異なっていて、かつ方向が交差していたら壁
+				if (IsKindOfRoomType(to) || IsKindOfSlopeType(to))
+					return differentIdentifier && selfCrossed;
+
+				// 空間なら壁
+				return IsKindOfSpatialType(to);
+			}
+			else if (IsKindOfRoomTypeWithoutGate(self))
+			{
+				// 門は部屋系のグリッドでもあるので注意
+				return
+					IsKindOfAisleType(to) ||
+					(!minimap && IsKindOfSlopeType(to)) ||
+					IsKindOfSpatialType(to);
+			}
+			else if (IsKindOfAisleType(self))
+			{
+				// 通路の識別子が違うなら壁
+				if (IsKindOfAisleType(to) || IsKindOfSlopeType(to))
+					return differentIdentifier;
+
+				return
+					IsKindOfRoomTypeWithoutGate(to) ||
+					IsKindOfSpatialType(to);
+			}
+			else if (IsKindOfSlopeType(self))
+			{
+				// 方向が交差しているか、識別子が不一致なら壁
+				if (IsKindOfSlopeType(to))
+					return toCrossed || differentIdentifier;
+
+				return IsKindOfSpatialType(to);
+			}
+			return false;
+		}
+
+		/*
+		自身からtoを見た時に扉が生成されるか判定します
+		*/
+		static constexpr bool GateRule(const uint8_t self, const uint8_t to, const uint8_t condition) noexcept
+		{
+			if (self != Gate)
+				return false;
+
+			// 門と門の間に通路が無い場合は、ゴールと反対方向のグリッドのみ門を生成する
+			if (to == Gate)
+				return (condition & GateSameDirection) && (condition & GateInverseDirection);
+
+			// 階段の正面が門と同じ方向なら門を生成する
+			if (IsKindOfSlopeType(to))
+				return (condition & GateSameAxis) && (condition & GateSameAxisAsDirection);
+
+			return IsKindOfAisleType(to);
+		}
+
+		/*
+		toに向かって柱が生成されるか判定します
+		*/
+		static constexpr bool PillarRule(const uint8_t to) noexcept
+		{
+			return
+				IsHorizontallyPassable(to) &&
+				to != Empty &&
+				to != Atrium &&
+				to != Slope;
+		}
+
+		static constexpr std::array<uint8_t, TypeSize * TypeSize> BuildFloorTable() noexcept
+		{
+			std::array<uint8_t, TypeSize * TypeSize> table{};
+			for (uint8_t self = 0; self < TypeSize; ++self)
+			{
+				for (uint8_t to = 0; to < TypeSize; ++to)
+				{
+					for (uint8_t condition = 0; condition < 2; ++condition)
+					{
+						if (FloorRule(self, to, condition))
+							table[Index(self, to)] |= static_cast<uint8_t>(1 << condition);
+					}
+				}
+			}
+			return table;
+		}
+
+		static constexpr uint64_t BuildRoofTable() noexcept
+		{
+			uint64_t table = 0;
+			for (uint8_t self = 0; self < TypeSize; ++self)
+			{
+				for (uint8_t to = 0; to < TypeSize; ++to)
+				{
+					if (RoofRule(self, to))
+						table |= static_cast<uint64_t>(1) << Index(self, to);
+				}
+			}
+			return table;
+		}
+
+		static constexpr std::array<uint16_t, TypeSize * TypeSize> BuildWallTable(const bool minimap) noexcept
+		{
+			std::array<uint16_t, TypeSize * TypeSize> table{};
+			for (uint8_t self = 0; self < TypeSize; ++self)
+			{
+				for (uint8_t to = 0; to < TypeSize; ++to)
+				{
+					for (uint8_t condition = 0; condition < 16; ++condition)
+					{
+						if (WallRule(self, to, condition, minimap))
+							table[Index(self, to)] |= static_cast<uint16_t>(1 << condition);
+					}
+				}
+			}
+			return table;
+		}
+
+		static constexpr std::array<uint16_t, TypeSize * TypeSize> BuildGateTable() noexcept
+		{
+			std::array<uint16_t, TypeSize * TypeSize> table{};
+			for (uint8_t self = 0; self < TypeSize; ++self)
+			{
+				for (uint8_t to = 0; to < TypeSize; ++to)
+				{
+					for (uint8_t condition = 0; condition < 16; ++condition)
+					{
+						if (GateRule(self, to, condition))
+							table[Index(self, to)] |= static_cast<uint16_t>(1 << condition);
+					}
+				}
+			}
+			return table;
+		}
+
+		static constexpr uint8_t BuildPillarTable() noexcept
+		{
+			uint8_t table = 0;
+			for (uint8_t to = 0; to < TypeSize; ++to)
+			{
+				if (PillarRule(to))
+					table |= static_cast<uint8_t>(1 << to);
+			}
+			return table;
+		}
+
+	public:
+		//! 床の表（要素のビット位置は床の条件）
+		static const std::array<uint8_t, TypeSize * TypeSize> FloorTable;
+
+		//! 屋根の表（ビット位置はIndex）
+		static const uint64_t RoofTable;
+
+		//! 壁の表（要素のビット位置は壁の条件）
+		static const std::array<uint16_t, TypeSize * TypeSize> WallTable;
+
+		//! ミニマップの壁の表（要素のビット位置は壁の条件）
+		static const std::array<uint16_t, TypeSize * TypeSize> WallForMinimapTable;
+
+		//! 扉の表（要素のビット位置は扉の条件）
+		static const std::array<uint16_t, TypeSize * TypeSize> GateTable;
+
+		//! 柱の表（ビット位置は参照先の種類）
+		static const uint8_t PillarTable;
+	};
+
+	// 表はクラスの定義が完了してから評価します
+	inline constexpr std::array<uint8_t, GridRuleTable::TypeSize * GridRuleTable::TypeSize> GridRuleTable::FloorTable = GridRuleTable::BuildFloorTable();
+	inline constexpr uint64_t GridRuleTable::RoofTable = GridRuleTable::BuildRoofTable();
+	inline constexpr std::array<uint16_t, GridRuleTable::TypeSize * GridRuleTable::TypeSize> GridRuleTable::WallTable = GridRuleTable::BuildWallTable(false);
+	inline constexpr std::array<uint16_t, GridRuleTable::TypeSize * GridRuleTable::TypeSize> GridRuleTable::WallForMinimapTable = GridRuleTable::BuildWallTable(true);
+	inline constexpr std::array<uint16_t, GridRuleTable::TypeSize * GridRuleTable::TypeSize> GridRuleTable::GateTable = GridRuleTable::BuildGateTable();
+	inline constexpr uint8_t GridRuleTable::PillarTable = GridRuleTable::BuildPillarTable();
+
+	// 代表的な規則が表に反映されているか確認します
+	static_assert((GridRuleTable::PillarTable & (1 << GridRuleTable::Aisle)) != 0, "A pillar must face aisles");
+	static_assert((GridRuleTable::PillarTable & (1 << GridRuleTable::Slope)) == 0, "A pillar must not face slopes");
+	static_assert((GridRuleTable::RoofTable >> GridRuleTable::Index(GridRuleTable::Floor, GridRuleTable::Empty) & 1) != 0, "A room under empty space must have a roof");
+	static_assert((GridRuleTable::RoofTable >> GridRuleTable::Index(GridRuleTable::Floor, GridRuleTable::Floor) & 1) == 0, "A room under its own floor must not have a roof");
+	static_assert((GridRuleTable::WallTable[GridRuleTable::Index(GridRuleTable::Floor, GridRuleTable::Deck)] & (1 << GridRuleTable::WallMergeRooms)) == 0, "Merged rooms must not have walls");
+	static_assert((GridRuleTable::WallTable[GridRuleTable::Index(GridRuleTable::Floor, GridRuleTable::Deck)] & (1 << 0)) != 0, "Different rooms must have walls");
+	static_assert((GridRuleTable::WallTable[GridRuleTable::Index(GridRuleTable::Floor, GridRuleTable::Slope)] & 1) != 0, "A room must have a wall to a slope");
+	static_assert((GridRuleTable::WallForMinimapTable[GridRuleTable::Index(GridRuleTable::Floor, GridRuleTable::Slope)] & 1) == 0, "The mini map omits walls from rooms to slopes");
+	static_assert(GridRuleTable::GateTable[GridRuleTable::Index(GridRuleTable::Gate, GridRuleTable::Aisle)] == 0xFFFF, "A gate must open to aisles");
+	static_assert(GridRuleTable::GateTable[GridRuleTable::Index(GridRuleTable::Aisle, GridRuleTable::Gate)] == 0, "Only gates have doors");
+	static_assert(GridRuleTable::FloorTable[GridRuleTable::Index(GridRuleTable::Empty, GridRuleTable::Floor)] == 0, "Empty space has no floor");
+}
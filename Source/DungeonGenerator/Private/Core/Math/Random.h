@@ -89,7 +89,39 @@ namespace dungeon
 			return instance;
 		}
 
+		/**
+		カウンターから乱数を取得します
+		状態を持たないので、同じ引数ならばスレッドや呼び出し順に関係なく同じ値を返します
+		\param[in]	seed		乱数の種
+		\param[in]	gridIndex	グリッドのインデックス
+		\param[in]	category	用途の種類
+		\param[in]	salt		同じ用途で別の値が必要な時の番号
+		\return		[0,std::numeric_limits<uint64_t>::max]の範囲を返す
+		*/
+		static constexpr uint64_t Counter(const uint64_t seed, const uint64_t gridIndex, const uint32_t category, const uint32_t salt = 0) noexcept;
+
+		/**
+		カウンターから初期化した乱数を取得します
+		グリッド毎の選択を他のグリッドの選択に関係なく決める時に使います
+		\param[in]	seed		乱数の種
+		\param[in]	gridIndex	グリッドのインデックス
+		\param[in]	category	用途の種類
+		\param[in]	salt		同じ用途で別の乱数が必要な時の番号
+		\return		乱数
+		*/
+		static Random Stream(const uint64_t seed, const uint64_t gridIndex, const uint32_t category, const uint32_t salt = 0) noexcept;
+
 	private:
+		/**
+		状態を直接設定するコンストラクタ
+		*/
+		Random(const uint32_t x, const uint32_t y, const uint32_t z, const uint32_t w) noexcept;
+
+		/**
+		SplitMix64で値を攪拌します
+		*/
+		static constexpr uint64_t SplitMix64(uint64_t value) noexcept;
+
 		/**
 		uint32_t型の乱数を取得します
 		\return		[0,std::numeric_limits<int32_t>::max]の範囲を返す
@@ -173,6 +173,41 @@ namespace dungeon
 		}
 	}
 
+	inline constexpr uint64_t Random::Counter(const uint64_t seed, const uint64_t gridIndex, const uint32_t category, const uint32_t salt) noexcept
+	{
+		const uint64_t key = (static_cast<uint64_t>(category) << 32) | salt;
+		return SplitMix64(SplitMix64(SplitMix64(seed) ^ gridIndex) ^ key);
+	}
+
+	inline Random Random::Stream(const uint64_t seed, const uint64_t gridIndex, const uint32_t category, const uint32_t salt) noexcept
+	{
+		// XorShiftの状態をカウンターの値で直接設定するので、全て0にならないようにする
+		uint64_t low = Counter(seed, gridIndex, category, salt);
+		uint64_t high = SplitMix64(low);
+		while (low == 0 && high == 0)
+			high = SplitMix64(high);
+		return Random(
+			static_cast<uint32_t>(low), static_cast<uint32_t>(low >> 32),
+			static_cast<uint32_t>(high), static_cast<uint32_t>(high >> 32)
+		);
+	}
+
+	inline Random::Random(const uint32_t x, const uint32_t y, const uint32_t z, const uint32_t w) noexcept
+		: mX(x)
+		, mY(y)
+		, mZ(z)
+		, mW(w)
+	{
+	}
+
+	inline constexpr uint64_t Random::SplitMix64(uint64_t value) noexcept
+	{
+		value += 0x9E3779B97F4A7C15ULL;
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+		return value ^ (value >> 31);
+	}
+
 	inline uint32_t Random::GetU32()
 	{
 		const uint32_t t = (mX ^ (mX << 11));
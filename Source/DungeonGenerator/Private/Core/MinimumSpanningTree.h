@@ -39,7 +39,8 @@ namespace dungeon
 		/**
 		生成した辺を更新します
 		*/
-		void ForEach(std::function<void(Edge&)> func) noexcept
+		template<typename Function>
+		void ForEach(Function&& func) noexcept
 		{
 			for (auto& node : mEdges)
 			{
@@ -50,7 +51,8 @@ namespace dungeon
 		/**
 		生成した辺を参照します
 		*/
-		void ForEach(std::function<void(const Edge&)> func) const noexcept
+		template<typename Function>
+		void ForEach(Function&& func) const noexcept
 		{
 			for (auto& node : mEdges)
 			{
@@ -58,6 +60,14 @@ namespace dungeon
 			}
 		}
 
+		/**
+		生成した辺のコンテナを取得します
+		*/
+		const std::vector<Edge>& GetEdges() const noexcept
+		{
+			return mEdges;
+		}
+
 		/**
 		最小スパニングツリーの辺の個数を取得します
 		\return		最小スパニングツリーの辺の個数
@@ -89,7 +99,8 @@ namespace dungeon
 		行き止まりの点を更新します
 		\param[in]	func	点を元に更新する関数
 		*/
-		void EachLeafPoint(std::function<void(const std::shared_ptr<const Point>& point)> func) const noexcept
+		template<typename Function>
+		void EachLeafPoint(Function&& func) const noexcept
 		{
 			for (const auto& point : mLeafPoints)
 			{
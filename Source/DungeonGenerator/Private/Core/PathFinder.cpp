@@ -41,10 +41,11 @@ namespace dungeon
 	{
 	}
 
-	PathFinder::OpenNode::OpenNode(const uint64_t parentKey, const NodeType nodeType, const FIntVector& location, const Direction direction, const SearchDirection searchDirection, const uint32_t cost) noexcept
+	PathFinder::OpenNode::OpenNode(const uint64_t parentKey, const NodeType nodeType, const FIntVector& location, const Direction direction, const SearchDirection searchDirection, const uint32_t cost, const uint32_t pathCost) noexcept
 		: BaseNode(nodeType, location, direction)
 		, mParentKey(parentKey)
 		, mCost(cost)
+		, mPathCost(pathCost)
 		, mSearchDirection(searchDirection)
 	{
 	}
@@ -53,6 +54,7 @@ namespace dungeon
 		: BaseNode(other)
 		, mParentKey(other.mParentKey)
 		, mCost(other.mCost)
+		, mPathCost(other.mPathCost)
 		, mSearchDirection(other.mSearchDirection)
 	{
 	}
@@ -61,6 +63,7 @@ namespace dungeon
 		: BaseNode(std::move(other))
 		, mParentKey(std::move(other.mParentKey))
 		, mCost(std::move(other.mCost))
+		, mPathCost(std::move(other.mPathCost))
 		, mSearchDirection(std::move(other.mSearchDirection))
 	{
 	}
@@ -86,6 +89,18 @@ namespace dungeon
 	{
 	}
 
+	PathFinder::PathFinder() noexcept
+	{
+	}
+
+	PathFinder::PathFinder(ScratchArena& arena) noexcept
+		: mNoEntryNodeSwitcher(&arena)
+		, mOpen(OpenNodeMap::allocator_type(&arena))
+		, mClose(CloseNodeMap::allocator_type(&arena))
+		, mRoute(ScratchAllocator<BaseNode>(&arena))
+	{
+	}
+
 	uint64_t PathFinder::Start(const FIntVector& location, const FIntVector& goal, const SearchDirection searchDirection) noexcept
 	{
 		// キーを生成
@@ -103,6 +118,9 @@ namespace dungeon
 		// コスト計算
 		const uint32_t newCost = TotalCost(cost, location, goal);
 
+		// 重み付きA*でなければ総コストを積み上げる
+		const uint32_t pathCost = mHeuristicsWeight > 0.f ? cost : newCost;
+
 		// Openリスト内を検索
 		const auto openNode = mOpen.find(key);
 
@@ -123,6 +141,7 @@ namespace dungeon
 				openNode->second.mParentKey = parentKey;
 				openNode->second.mSearchDirection = searchDirection;
 				openNode->second.mCost = newCost;
+				openNode->second.mPathCost = pathCost;
 			}
 		}
 		// クローズリストに追加するノードがある。かつ、新しいノードの方がトータルコストが低い
@@ -133,16 +152,18 @@ namespace dungeon
 				// Closeリストから消す
 				mClose.erase(closeNode);
 				// Openリストに再登録
-				mOpen.emplace(key, OpenNode(parentKey, nodeType, location, direction, searchDirection, newCost));
+				mOpen.emplace(key, OpenNode(parentKey, nodeType, location, direction, searchDirection, newCost, pathCost));
 
 				RevertOpenNode(key);
+				CountOpenedNode();
 			}
 		}
 		// オープンとクローズリストに追加するノードがない
 		else
 		{
 			// Openリストに登録
-			mOpen.emplace(key, OpenNode(parentKey, nodeType, location, direction, searchDirection, newCost));
+			mOpen.emplace(key, OpenNode(parentKey, nodeType, location, direction, searchDirection, newCost, pathCost));
+			CountOpenedNode();
 		}
 
 		return key;
@@ -153,15 +174,21 @@ namespace dungeon
 		return mOpen.empty();
 	}
 
+	bool PathFinder::IsClosed(const FIntVector& location, const NodeType nodeType) const noexcept
+	{
+		const auto closeNode = mClose.find(Hash(location));
+		return closeNode != mClose.end() && closeNode->second.mNodeType == nodeType;
+	}
+
 	bool PathFinder::Pop(uint64_t& key, NodeType& nodeType, uint32_t& cost, FIntVector& location, Direction& direction, SearchDirection& searchDirection) noexcept
 	{
 		if (mOpen.empty())
 			return false;
 
 		// 最もコストの低いノードを検索
-		std::unordered_map<uint64_t, OpenNode>::iterator result = mOpen.begin();
+		OpenNodeMap::iterator result = mOpen.begin();
 		uint32_t minimumCost = std::numeric_limits<uint32_t>::max();
-		for (std::unordered_map<uint64_t, OpenNode>::iterator i = mOpen.begin(); i != mOpen.end(); ++i)
+		for (OpenNodeMap::iterator i = mOpen.begin(); i != mOpen.end(); ++i)
 		{
 			if (minimumCost > (*i).second.mCost)
 			{
@@ -184,7 +211,7 @@ namespace dungeon
 		location = result->second.mLocation;
 		nodeType = result->second.mNodeType;
 		direction = result->second.mDirection;
-		cost = result->second.mCost;
+		cost = result->second.mPathCost;
 		searchDirection = result->second.mSearchDirection;
 
 		// Closeノードに追加
@@ -195,6 +222,10 @@ namespace dungeon
 
 		UseOpenNode(key);
 
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		++mStatistics.mClosedNodeCount;
+#endif
+
 		return true;
 	}
 
@@ -308,13 +339,15 @@ namespace dungeon
 			static_cast<uint64_t>(location.X);
 	}
 
-	uint32_t PathFinder::TotalCost(const uint32_t cost, const FIntVector& location, const FIntVector& goal) noexcept
+	uint32_t PathFinder::TotalCost(const uint32_t cost, const FIntVector& location, const FIntVector& goal) const noexcept
 	{
 		return TotalCost(cost, Heuristics(location, goal));
 	}
 
-	uint32_t PathFinder::TotalCost(const uint32_t cost, const uint32_t heuristics) noexcept
+	uint32_t PathFinder::TotalCost(const uint32_t cost, const uint32_t heuristics) const noexcept
 	{
+		if (mHeuristicsWeight > 0.f)
+			return cost + static_cast<uint32_t>(static_cast<float>(heuristics) * mHeuristicsWeight + 0.5f);
 		return cost + heuristics;
 	}
 
@@ -356,12 +389,9 @@ namespace dungeon
 
 
 
-	void PathFinder::ReserveOpenNode(const FIntVector& parentLocation, const std::shared_ptr<PathNodeSwitcher::Node>& openNode)
+	void PathFinder::ReserveOpenNode(const FIntVector& parentLocation, const FIntVector& noEntry0, const FIntVector& noEntry1)
 	{
-		const uint64_t parentHash = Hash(parentLocation);
-		// 親ノードがオープンリストにあるなら、進入禁止予約リストに登録
-		mNoEntryNodeSwitcher.Reserve(parentHash, openNode);
-		// クローズリストにあるなら、進入禁止リストに登録
+		mNoEntryNodeSwitcher.Reserve(Hash(parentLocation), Hash(noEntry0), Hash(noEntry1));
 	}
 
 	bool PathFinder::IsUsingOpenNode(const FIntVector& location) const
@@ -9,6 +9,8 @@ All Rights Reserved.
 #pragma once
 #include "Direction.h"
 #include "PathNodeSwitcher.h"
+#include "ScratchArena.h"
+#include "SearchStatistics.h"
 #include <functional>
 #include <unordered_map>
 #include <unordered_set>
@@ -107,8 +109,9 @@ namespace dungeon
 			\param[in]	direction		検索してきた方向
 			\param[in]	searchDirection	検索可能な方向
 			\param[in]	cost			現在コスト
+			\param[in]	pathCost		始点からのコスト
 			*/
-			OpenNode(const uint64_t parentKey, const NodeType nodeType, const FIntVector& location, const Direction direction, const SearchDirection searchDirection, const uint32_t cost) noexcept;
+			OpenNode(const uint64_t parentKey, const NodeType nodeType, const FIntVector& location, const Direction direction, const SearchDirection searchDirection, const uint32_t cost, const uint32_t pathCost) noexcept;
 
 			/**
 			コピーコンストラクタ
@@ -122,6 +125,7 @@ namespace dungeon
 
 			uint64_t mParentKey;
 			uint32_t mCost;
+			uint32_t mPathCost;
 			SearchDirection mSearchDirection;
 		};
 
@@ -154,6 +158,31 @@ namespace dungeon
 		};
 
 	public:
+		/**
+		コンストラクタ
+		作業領域はヒープから確保します
+		*/
+		PathFinder() noexcept;
+
+		/**
+		コンストラクタ
+		\param[in]	arena	作業領域を確保するアリーナ
+		*/
+		explicit PathFinder(ScratchArena& arena) noexcept;
+
+		/**
+		重み付きA*で探索します
+		総コストを 始点からのコスト + weight × ヒューリスティック で計算し、
+		始点からのコストと総コストを分けて管理します。
+		階段は前方と上下に1グリッドずつ進むのでマンハッタン距離は2変わりますが、コストは1です。
+		そのため重みが1でもヒューリスティックは実際のコストを上回る事があり、
+		経路が最短になる保証や、長さの上限はありません。
+		呼び出さない場合は従来通り総コストを積み上げて探索します。
+		Startより前に呼び出して下さい。
+		\param[in]	weight	ヒューリスティックの重み（1以上）
+		*/
+		void SetHeuristicsWeight(const float weight) noexcept;
+
 		/**
 		ノードを開く
 		\param[in]	location		現在位置
@@ -182,11 +211,27 @@ namespace dungeon
 		*/
 		bool Empty() const noexcept;
 
+		/**
+		ノードがCloseリストにあるか調べます
+		\param[in]	location	位置
+		\param[in]	nodeType	ノードの種類
+		\return		trueならばnodeTypeのノードとしてCloseリストにある
+		*/
+		bool IsClosed(const FIntVector& location, const NodeType nodeType) const noexcept;
+
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		/**
+		探索の統計を取得します
+		*/
+		SearchStatistics& GetStatistics() noexcept;
+		const SearchStatistics& GetStatistics() const noexcept;
+#endif
+
 		/**
 		最も有望な位置を取得します
 		\param[out]	nextKey				次に開く事ができるノードのキー
 		\param[out]	nextNodeType		次のノードの種類
-		\param[out]	nextCost			次のコスト
+		\param[out]	nextCost			次のコスト（重み付きA*ならば始点からのコスト）
 		\param[out]	nextLocation		次の位置
 		\param[out]	nextDirection		次の方向
 		\param[out]	nextSearchDirection	次に検索可能な方向
@@ -237,11 +282,13 @@ namespace dungeon
 
 
 		/*
-		使用中ノードと関連するノードの予約をする
-		\param[in]		location	
-		\param[in]		std::shared_ptr<PathNodeSwitcher::Node>
+		階段ノードが使う二つのグリッドを予約します
+		予約したグリッドは、階段ノードを展開すると使用中になります
+		\param[in]		location	階段ノードの位置
+		\param[in]		noEntry0	階段ノードが使うグリッドの位置
+		\param[in]		noEntry1	階段ノードが使うグリッドの位置
 		*/
-		void ReserveOpenNode(const FIntVector& location, const std::shared_ptr<PathNodeSwitcher::Node>& openNode);
+		void ReserveOpenNode(const FIntVector& location, const FIntVector& noEntry0, const FIntVector& noEntry1);
 
 		/*
 		ノードと関連ノードが使用中か調べます
@@ -267,6 +314,11 @@ namespace dungeon
 		*/
 		void ClearOpenNode();
 
+		/*
+		開いたノードを統計に記録する
+		*/
+		void CountOpenedNode() noexcept;
+
 	public:
 		/**
 		位置からハッシュキーを計算
@@ -283,7 +335,7 @@ namespace dungeon
 		\param[in]	goal		ゴール位置
 		\return		総コスト
 		*/
-		static uint32_t TotalCost(const uint32_t cost, const FIntVector& location, const FIntVector& goal) noexcept;
+		uint32_t TotalCost(const uint32_t cost, const FIntVector& location, const FIntVector& goal) const noexcept;
 
 		/**
 		総コストを計算を取得
@@ -291,7 +343,7 @@ namespace dungeon
 		\param[in]	heuristics	ヒューリスティック
 		\return		総コスト
 		*/
-		static uint32_t TotalCost(const uint32_t cost, const uint32_t heuristics) noexcept;
+		uint32_t TotalCost(const uint32_t cost, const uint32_t heuristics) const noexcept;
 
 		/**
 		ヒューリスティックを取得
@@ -302,10 +354,20 @@ namespace dungeon
 		static uint32_t Heuristics(const FIntVector& location, const FIntVector& goal) noexcept;
 
 	private:
+		template<typename T>
+		using NodeMap = std::unordered_map<uint64_t, T, std::hash<uint64_t>, std::equal_to<uint64_t>, ScratchAllocator<std::pair<const uint64_t, T>>>;
+		using OpenNodeMap = NodeMap<OpenNode>;
+		using CloseNodeMap = NodeMap<CloseNode>;
+
 		PathNodeSwitcher mNoEntryNodeSwitcher;
-		std::unordered_map<uint64_t, OpenNode> mOpen;
-		std::unordered_map<uint64_t, CloseNode> mClose;
-		std::vector<BaseNode> mRoute;
+		OpenNodeMap mOpen;
+		CloseNodeMap mClose;
+		std::vector<BaseNode, ScratchAllocator<BaseNode>> mRoute;
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		SearchStatistics mStatistics;
+#endif
+		//! ヒューリスティックの重み（0ならば総コストを積み上げる従来の探索）
+		float mHeuristicsWeight = 0.f;
 	};
 }
 
@@ -10,4 +10,29 @@ All Rights Reserved.
 
 namespace dungeon
 {
+	inline void PathFinder::SetHeuristicsWeight(const float weight) noexcept
+	{
+		check(weight >= 1.f);
+		mHeuristicsWeight = weight;
+	}
+
+	inline void PathFinder::CountOpenedNode() noexcept
+	{
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		++mStatistics.mOpenedNodeCount;
+		mStatistics.mPeakOpenNodeCount = std::max(mStatistics.mPeakOpenNodeCount, mOpen.size());
+#endif
+	}
+
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+	inline SearchStatistics& PathFinder::GetStatistics() noexcept
+	{
+		return mStatistics;
+	}
+
+	inline const SearchStatistics& PathFinder::GetStatistics() const noexcept
+	{
+		return mStatistics;
+	}
+#endif
 }
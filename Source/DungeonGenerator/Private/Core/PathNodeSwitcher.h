@@ -7,47 +7,81 @@ All Rights Reserved.
 */
 
 #pragma once
+#include "ScratchArena.h"
 #include <Math/IntVector.h>
-#include <memory>
+#include <array>
 #include <unordered_map>
-#include <unordered_set>
 
 namespace dungeon
 {
 	/*
 	パス検索ノードの予約・使用中切り替えクラス
+	階段ノードが使う二つのグリッドを、階段ノードのハッシュ値と一緒に記録します。
+	グリッド毎に使用中の階段の数を数えるので、予約・使用中の切り替えと使用中の判定は
+	メモリ確保をせずに一定時間で終わります。
 	*/
 	class PathNodeSwitcher
 	{
 	public:
-		class Node final
-		{
-		public:
-			void Add(const uint64_t key);
-			bool Contain(const uint64_t key) const;
-
-		private:
-			std::unordered_set<uint64_t> mNodes;
-		};
-
-	public:
-		PathNodeSwitcher() = default;
+		/*
+		コンストラクタ
+		\param[in]	arena	記録を確保するアリーナ（nullptrならヒープ）
+		*/
+		explicit PathNodeSwitcher(ScratchArena* arena = nullptr) noexcept;
 
 		virtual ~PathNodeSwitcher() = default;
 
-		void Reserve(const uint64_t parentHashey, const std::shared_ptr<Node>& node);
+		/*
+		ノードが使うグリッドを予約します
+		\param[in]	parentHash	ノードのハッシュ値
+		\param[in]	key0		ノードが使うグリッドのハッシュ値
+		\param[in]	key1		ノードが使うグリッドのハッシュ値
+		*/
+		void Reserve(const uint64_t parentHash, const uint64_t key0, const uint64_t key1);
 
+		/*
+		予約されたグリッドを使用中に変更します
+		\param[in]	parentHash	ノードのハッシュ値
+		*/
 		void Use(const uint64_t parentHash);
 
+		/*
+		使用中のグリッドを予約に戻します
+		\param[in]	parentHash	ノードのハッシュ値
+		*/
 		void Revert(const uint64_t parentHash);
 
+		/*
+		グリッドが使用中か調べます
+		\param[in]	key		グリッドのハッシュ値
+		*/
 		bool IsUsing(const uint64_t key) const;
 
 		void Clear();
 
 	private:
-		std::unordered_map<uint64_t, std::shared_ptr<Node>> mReserved;
-		std::unordered_map<uint64_t, std::shared_ptr<Node>> mUsed;
+		using Keys = std::array<uint64_t, 2>;
+
+		/*
+		ノードが使うグリッドの記録
+		使用中のまま予約し直す事があるので、予約と使用中を別々に持ちます
+		*/
+		struct Record final
+		{
+			Keys mReserved;
+			Keys mUsing;
+			bool mHasReserved = false;
+			bool mHasUsing = false;
+		};
+
+		void AddUsingCount(const Keys& keys);
+		void SubtractUsingCount(const Keys& keys);
+
+		template<typename T>
+		using NodeMap = std::unordered_map<uint64_t, T, std::hash<uint64_t>, std::equal_to<uint64_t>, ScratchAllocator<std::pair<const uint64_t, T>>>;
+
+		NodeMap<Record> mRecords;
+		NodeMap<uint32_t> mUsingCounts;
 	};
 }
 
@@ -7,61 +7,76 @@ All Rights Reserved.
 */
 
 #pragma once
-#include "PathFinder.h"
 #include "PathNodeSwitcher.h"
 
 namespace dungeon
 {
-	inline void PathNodeSwitcher::Node::Add(const uint64_t key)
+	inline PathNodeSwitcher::PathNodeSwitcher(ScratchArena* arena) noexcept
+		: mRecords(NodeMap<Record>::allocator_type(arena))
+		, mUsingCounts(NodeMap<uint32_t>::allocator_type(arena))
 	{
-		mNodes.emplace(key);
 	}
 
-	inline bool PathNodeSwitcher::Node::Contain(const uint64_t key) const
+	inline void PathNodeSwitcher::Reserve(const uint64_t parentHash, const uint64_t key0, const uint64_t key1)
 	{
-		return mNodes.find(key) != mNodes.end();
+		Record& record = mRecords[parentHash];
+		record.mReserved = { key0, key1 };
+		record.mHasReserved = true;
 	}
 
-
-
-	inline void PathNodeSwitcher::Reserve(const uint64_t parentHash, const std::shared_ptr<Node>& node)
-	{
-		mReserved[parentHash] = node;
-	}
-   
 	inline void PathNodeSwitcher::Use(const uint64_t parentHash)
 	{
-		auto iterator = mReserved.find(parentHash);
-		if (iterator != mReserved.end())
+		auto iterator = mRecords.find(parentHash);
+		if (iterator != mRecords.end() && iterator->second.mHasReserved)
 		{
-			mUsed[parentHash] = iterator->second;
-			mReserved.erase(iterator);
+			Record& record = iterator->second;
+			if (record.mHasUsing)
+				SubtractUsingCount(record.mUsing);
+			AddUsingCount(record.mReserved);
+			record.mUsing = record.mReserved;
+			record.mHasUsing = true;
+			record.mHasReserved = false;
 		}
 	}
 
 	inline void PathNodeSwitcher::Revert(const uint64_t parentHash)
 	{
-		auto iterator = mUsed.find(parentHash);
-		if (iterator != mUsed.end())
+		auto iterator = mRecords.find(parentHash);
+		if (iterator != mRecords.end() && iterator->second.mHasUsing)
 		{
-			mReserved[parentHash] = iterator->second;
-			mUsed.erase(iterator);
+			Record& record = iterator->second;
+			SubtractUsingCount(record.mUsing);
+			record.mReserved = record.mUsing;
+			record.mHasReserved = true;
+			record.mHasUsing = false;
 		}
 	}
 
 	inline bool PathNodeSwitcher::IsUsing(const uint64_t key) const
 	{
-		for (const auto& node : mUsed)
-		{
-			if (node.second->Contain(key))
-				return true;
-		}
-		return false;
+		const auto iterator = mUsingCounts.find(key);
+		return iterator != mUsingCounts.end() && iterator->second > 0;
 	}
 
 	inline void PathNodeSwitcher::Clear()
 	{
-		mReserved.clear();
-		mUsed.clear();
+		mRecords.clear();
+		mUsingCounts.clear();
+	}
+
+	inline void PathNodeSwitcher::AddUsingCount(const Keys& keys)
+	{
+		for (const uint64_t key : keys)
+			++mUsingCounts[key];
+	}
+
+	inline void PathNodeSwitcher::SubtractUsingCount(const Keys& keys)
+	{
+		for (const uint64_t key : keys)
+		{
+			auto iterator = mUsingCounts.find(key);
+			check(iterator != mUsingCounts.end() && iterator->second > 0);
+			--iterator->second;
+		}
 	}
 }
@@ -0,0 +1,192 @@
+/**
+通路の経路キャッシュ ソースファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#include "RouteCache.h"
+#include "GateCandidateCache.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace dungeon
+{
+	namespace
+	{
+		inline size_t Combine(const size_t seed, const int32_t value) noexcept
+		{
+			return seed ^ (static_cast<size_t>(static_cast<uint32_t>(value)) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+		}
+	}
+
+	bool RouteCache::Key::operator==(const Key& other) const noexcept
+	{
+		return
+			mStart == other.mStart &&
+			mGoal == other.mGoal &&
+			mGoalRect == other.mGoalRect;
+	}
+
+	size_t RouteCache::KeyHash::operator()(const Key& key) const noexcept
+	{
+		size_t seed = 0;
+		seed = Combine(seed, key.mStart.X);
+		seed = Combine(seed, key.mStart.Y);
+		seed = Combine(seed, key.mStart.Z);
+		seed = Combine(seed, key.mGoal.X);
+		seed = Combine(seed, key.mGoal.Y);
+		seed = Combine(seed, key.mGoal.Z);
+		seed = Combine(seed, key.mGoalRect.Min.X);
+		seed = Combine(seed, key.mGoalRect.Min.Y);
+		seed = Combine(seed, key.mGoalRect.Max.X);
+		seed = Combine(seed, key.mGoalRect.Max.Y);
+		return seed;
+	}
+
+	void RouteCache::Begin(const Voxel& voxel, const AisleSearchMode mode, const float heuristicsWeight) noexcept
+	{
+		if (mWidth != voxel.GetWidth() || mDepth != voxel.GetDepth() || mHeight != voxel.GetHeight() ||
+			mSearchMode != mode || mHeuristicsWeight != heuristicsWeight)
+		{
+			Clear();
+			mWidth = voxel.GetWidth();
+			mDepth = voxel.GetDepth();
+			mHeight = voxel.GetHeight();
+			mSearchMode = mode;
+			mHeuristicsWeight = heuristicsWeight;
+		}
+
+		mNextEntries.clear();
+		mReplayedCount = 0;
+	}
+
+	void RouteCache::End() noexcept
+	{
+		mEntries = std::move(mNextEntries);
+		mNextEntries.clear();
+	}
+
+	void RouteCache::Clear() noexcept
+	{
+		mEntries.clear();
+		mNextEntries.clear();
+	}
+
+	bool RouteCache::Contains(const Key& key) const noexcept
+	{
+		return mEntries.find(key) != mEntries.end();
+	}
+
+	bool RouteCache::Replay(Voxel::Route& route, FIntVector& gate, const Key& key, const Voxel& voxel, const GateCandidateCache* gateCandidates) noexcept
+	{
+		const auto entry = mEntries.find(key);
+		if (entry == mEntries.end())
+			return false;
+
+		// 参照したボクセルと門の候補が記録した時と同じならば、探索しても同じ経路になる
+		const Entry& cached = entry->second;
+		if (cached.mGateCandidatesHash != (gateCandidates ? gateCandidates->Hash(key.mStart) : 0))
+			return false;
+
+		for (size_t i = 0; i < cached.mReadIndices.size(); ++i)
+		{
+			if (voxel[cached.mReadIndices[i]].GetType() != cached.mReadTypes[i])
+				return false;
+		}
+
+		gate = cached.mGate;
+		Decode(route, cached.mRuns);
+		mNextEntries.emplace(key, cached);
+		++mReplayedCount;
+		return true;
+	}
+
+	void RouteCache::Store(const Key& key, const FIntVector& gate, const Voxel::Route& route, const std::vector<size_t>& readIndices, const Voxel& voxel, const GateCandidateCache* gateCandidates)
+	{
+		Entry entry;
+		entry.mGate = gate;
+		entry.mGateCandidatesHash = gateCandidates ? gateCandidates->Hash(key.mStart) : 0;
+		Encode(entry.mRuns, route);
+
+		// 門の検索は始点のグリッドから始まるので、始点も参照したボクセルに含める
+		entry.mReadIndices.reserve(readIndices.size() + 1);
+		entry.mReadIndices.push_back(static_cast<uint32_t>(voxel.Index(key.mStart)));
+		for (const size_t index : readIndices)
+			entry.mReadIndices.push_back(static_cast<uint32_t>(index));
+		std::sort(entry.mReadIndices.begin(), entry.mReadIndices.end());
+		entry.mReadIndices.erase(std::unique(entry.mReadIndices.begin(), entry.mReadIndices.end()), entry.mReadIndices.end());
+		entry.mReadIndices.shrink_to_fit();
+
+		entry.mReadTypes.reserve(entry.mReadIndices.size());
+		for (const uint32_t index : entry.mReadIndices)
+			entry.mReadTypes.push_back(voxel[index].GetType());
+
+		mNextEntries[key] = std::move(entry);
+	}
+
+	size_t RouteCache::GetReplayedCount() const noexcept
+	{
+		return mReplayedCount;
+	}
+
+	void RouteCache::Encode(std::vector<Run>& runs, const Voxel::Route& route)
+	{
+		runs.clear();
+		const Voxel::RouteNode* previous = nullptr;
+		for (const Voxel::RouteNode& node : route)
+		{
+			const Voxel::RouteNode* last = previous;
+			previous = &node;
+
+			if (last)
+			{
+				// 直前の連続したノードの延長ならば数を増やすだけ
+				Run& run = runs.back();
+				const FIntVector step = node.mLocation - last->mLocation;
+				if (run.mType == node.mType && run.mDirection.Get() == node.mDirection.Get() && run.mCount < std::numeric_limits<uint16_t>::max())
+				{
+					if (run.mCount == 1 && std::abs(step.X) <= 1 && std::abs(step.Y) <= 1 && std::abs(step.Z) <= 1)
+					{
+						run.mStepX = static_cast<int8_t>(step.X);
+						run.mStepY = static_cast<int8_t>(step.Y);
+						run.mStepZ = static_cast<int8_t>(step.Z);
+						++run.mCount;
+						continue;
+					}
+					else if (step == FIntVector(run.mStepX, run.mStepY, run.mStepZ))
+					{
+						++run.mCount;
+						continue;
+					}
+				}
+			}
+
+			Run run;
+			run.mLocation = node.mLocation;
+			run.mStepX = run.mStepY = run.mStepZ = 0;
+			run.mType = node.mType;
+			run.mDirection = node.mDirection;
+			run.mCount = 1;
+			runs.push_back(run);
+		}
+		runs.shrink_to_fit();
+	}
+
+	void RouteCache::Decode(Voxel::Route& route, const std::vector<Run>& runs)
+	{
+		route.clear();
+		for (const Run& run : runs)
+		{
+			const FIntVector step(run.mStepX, run.mStepY, run.mStepZ);
+			FIntVector location = run.mLocation;
+			for (uint16_t i = 0; i < run.mCount; ++i)
+			{
+				route.push_back({ location, run.mType, run.mDirection });
+				location += step;
+			}
+		}
+	}
+}
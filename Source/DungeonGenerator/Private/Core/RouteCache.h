@@ -0,0 +1,158 @@
+/**
+通路の経路キャッシュ ヘッダーファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+#include "AisleSearchMode.h"
+#include "Voxel.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace dungeon
+{
+	// 前方宣言
+	class GateCandidateCache;
+
+	/**
+	通路の経路キャッシュクラス
+	確定した通路の経路を、両端の部屋と探索中に参照したボクセルと一緒に記録します。
+	再生成で同じ通路を探索する時に、参照したボクセルが変わっていなければ
+	探索した場合と同じ経路になるので、A*を実行せずに記録した経路を再生します。
+	前回の生成で記録した経路だけを再生に使い、今回の生成で使わなかった経路は破棄します。
+	*/
+	class RouteCache final
+	{
+	public:
+		/**
+		通路のキー
+		識別子は生成毎に変わるので、両端の位置と終点の部屋の範囲で通路を区別します
+		*/
+		struct Key final
+		{
+			FIntVector mStart;
+			FIntVector mGoal;
+			FIntRect mGoalRect;
+
+			bool operator==(const Key& other) const noexcept;
+		};
+
+	public:
+		/**
+		コンストラクタ
+		*/
+		RouteCache() noexcept = default;
+		RouteCache(const RouteCache&) = delete;
+		RouteCache& operator=(const RouteCache&) = delete;
+
+		/**
+		デストラクタ
+		*/
+		~RouteCache() = default;
+
+		/**
+		生成を開始します
+		ボクセル空間の大きさや探索方法が前回の生成と違う場合は、記録を全て破棄します
+		\param[in]	voxel				ボクセル
+		\param[in]	mode				探索方法
+		\param[in]	heuristicsWeight	重み付きA*のヒューリスティックの重み
+		*/
+		void Begin(const Voxel& voxel, const AisleSearchMode mode, const float heuristicsWeight) noexcept;
+
+		/**
+		生成を終了します
+		今回の生成で記録または再生した経路だけを次の生成に残します
+		*/
+		void End() noexcept;
+
+		/**
+		記録を全て破棄します
+		*/
+		void Clear() noexcept;
+
+		/**
+		前回の生成で記録した経路があるか調べます
+		\param[in]	key		通路のキー
+		*/
+		bool Contains(const Key& key) const noexcept;
+
+		/**
+		記録した経路を取り出します
+		\param[out]	route			経路
+		\param[out]	gate			門の位置
+		\param[in]	key				通路のキー
+		\param[in]	voxel			ボクセル
+		\param[in]	gateCandidates	部屋の外周にある門の候補（nullptr可）
+		\return		falseならば記録が無いか、参照したボクセルが変わっているので探索して下さい
+		*/
+		bool Replay(Voxel::Route& route, FIntVector& gate, const Key& key, const Voxel& voxel, const GateCandidateCache* gateCandidates) noexcept;
+
+		/**
+		探索した経路を記録します
+		ボクセルに書き込む前に呼び出して下さい
+		\param[in]	key				通路のキー
+		\param[in]	gate			門の位置
+		\param[in]	route			経路
+		\param[in]	readIndices		探索中に参照したボクセルのインデックス
+		\param[in]	voxel			ボクセル
+		\param[in]	gateCandidates	部屋の外周にある門の候補（nullptr可）
+		*/
+		void Store(const Key& key, const FIntVector& gate, const Voxel::Route& route, const std::vector<size_t>& readIndices, const Voxel& voxel, const GateCandidateCache* gateCandidates);
+
+		/**
+		今回の生成で再生した経路の数を取得します
+		*/
+		size_t GetReplayedCount() const noexcept;
+
+	private:
+		/**
+		向きと種類が同じで、一定の間隔で並んだ経路のノード
+		*/
+		struct Run final
+		{
+			FIntVector mLocation;
+			int8_t mStepX;
+			int8_t mStepY;
+			int8_t mStepZ;
+			Grid::Type mType;
+			Direction mDirection;
+			uint16_t mCount;
+		};
+
+		/**
+		記録した通路
+		*/
+		struct Entry final
+		{
+			FIntVector mGate;
+			std::vector<Run> mRuns;
+			std::vector<uint32_t> mReadIndices;
+			std::vector<Grid::Type> mReadTypes;
+			uint64_t mGateCandidatesHash;
+		};
+
+		struct KeyHash final
+		{
+			size_t operator()(const Key& key) const noexcept;
+		};
+
+		using EntryMap = std::unordered_map<Key, Entry, KeyHash>;
+
+		static void Encode(std::vector<Run>& runs, const Voxel::Route& route);
+		static void Decode(Voxel::Route& route, const std::vector<Run>& runs);
+
+	private:
+		EntryMap mEntries;
+		EntryMap mNextEntries;
+		uint32_t mWidth = 0;
+		uint32_t mDepth = 0;
+		uint32_t mHeight = 0;
+		float mHeuristicsWeight = 0.f;
+		AisleSearchMode mSearchMode = AisleSearchMode::Standard;
+		size_t mReplayedCount = 0;
+	};
+}
@@ -0,0 +1,92 @@
+/**
+作業領域アリーナ ソースファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#include "ScratchArena.h"
+#include <algorithm>
+
+namespace dungeon
+{
+	ScratchArena::ScratchArena(const size_t blockSize) noexcept
+		: mBlockSize(blockSize)
+	{
+		mFreeLists.fill(nullptr);
+	}
+
+	void* ScratchArena::Allocate(const size_t size, const size_t alignment)
+	{
+		// 小さな領域はサイズ別に丸めて空きリストから再利用する
+		size_t allocateSize = size;
+		size_t allocateAlignment = alignment;
+		if (0 < size && size <= SizeClassUnit * SizeClassCount)
+		{
+			const size_t sizeClass = SizeClass(size);
+			if (alignment <= SizeClassUnit)
+			{
+				FreeNode* node = mFreeLists[sizeClass];
+				if (node)
+				{
+					mFreeLists[sizeClass] = node->mNext;
+					return node;
+				}
+			}
+			allocateSize = (sizeClass + 1) * SizeClassUnit;
+			allocateAlignment = std::max(alignment, SizeClassUnit);
+		}
+
+		// 現在のブロックから切り出す。足りなければ次のブロックへ進む
+		while (mCurrentBlock < mBlocks.size())
+		{
+			Block& block = mBlocks[mCurrentBlock];
+			const uintptr_t base = reinterpret_cast<uintptr_t>(block.mBuffer.get());
+			const uintptr_t aligned = (base + mOffset + allocateAlignment - 1) & ~static_cast<uintptr_t>(allocateAlignment - 1);
+			const size_t offset = static_cast<size_t>(aligned - base);
+			if (offset + allocateSize <= block.mSize)
+			{
+				mOffset = offset + allocateSize;
+				return block.mBuffer.get() + offset;
+			}
+
+			++mCurrentBlock;
+			mOffset = 0;
+		}
+
+		// 再利用できるブロックが無いのでシステムから確保する
+		const size_t blockSize = std::max(mBlockSize, allocateSize + allocateAlignment);
+		mBlocks.push_back({ std::make_unique<uint8_t[]>(blockSize), blockSize });
+		mCurrentBlock = mBlocks.size() - 1;
+
+		Block& block = mBlocks.back();
+		const uintptr_t base = reinterpret_cast<uintptr_t>(block.mBuffer.get());
+		const uintptr_t aligned = (base + allocateAlignment - 1) & ~static_cast<uintptr_t>(allocateAlignment - 1);
+		const size_t offset = static_cast<size_t>(aligned - base);
+		mOffset = offset + allocateSize;
+		return block.mBuffer.get() + offset;
+	}
+
+	void ScratchArena::Deallocate(void* pointer, const size_t size) noexcept
+	{
+		if (pointer == nullptr)
+			return;
+
+		// 小さな領域は空きリストに戻す。それ以外はResetまで保持する
+		if (0 < size && size <= SizeClassUnit * SizeClassCount)
+		{
+			const size_t sizeClass = SizeClass(size);
+			FreeNode* node = static_cast<FreeNode*>(pointer);
+			node->mNext = mFreeLists[sizeClass];
+			mFreeLists[sizeClass] = node;
+		}
+	}
+
+	void ScratchArena::Reset() noexcept
+	{
+		mFreeLists.fill(nullptr);
+		mCurrentBlock = 0;
+		mOffset = 0;
+	}
+}
@@ -0,0 +1,133 @@
+/**
+作業領域アリーナ ヘッダーファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dungeon
+{
+	/**
+	作業領域アリーナクラス
+	確保したブロックを解放せずにResetで巻き戻して再利用します。
+	小さな領域は解放時にサイズ別の空きリストに戻して再利用します。
+	*/
+	class ScratchArena final
+	{
+	public:
+		/**
+		コンストラクタ
+		\param[in]	blockSize	一度に確保するブロックの大きさ
+		*/
+		explicit ScratchArena(const size_t blockSize = 64 * 1024) noexcept;
+		ScratchArena(const ScratchArena&) = delete;
+		ScratchArena& operator=(const ScratchArena&) = delete;
+
+		/**
+		デストラクタ
+		*/
+		~ScratchArena() = default;
+
+		/**
+		領域を確保します
+		\param[in]	size		大きさ
+		\param[in]	alignment	アライメント
+		\return		確保した領域
+		*/
+		void* Allocate(const size_t size, const size_t alignment);
+
+		/**
+		領域を解放します
+		小さな領域は空きリストに戻り、それ以外はResetまで解放されません
+		\param[in]	pointer		Allocateで確保した領域
+		\param[in]	size		Allocateに渡した大きさ
+		*/
+		void Deallocate(void* pointer, const size_t size) noexcept;
+
+		/**
+		全ての領域を未使用に戻します
+		ブロックは解放せずに次の確保で再利用します。
+		アリーナから確保したオブジェクトは全て破棄してから呼び出して下さい。
+		*/
+		void Reset() noexcept;
+
+		/**
+		システムから確保したブロックの数を取得します
+		*/
+		size_t GetBlockCount() const noexcept;
+
+	private:
+		static size_t SizeClass(const size_t size) noexcept;
+
+	private:
+		struct Block final
+		{
+			std::unique_ptr<uint8_t[]> mBuffer;
+			size_t mSize;
+		};
+
+		struct FreeNode final
+		{
+			FreeNode* mNext;
+		};
+
+		static constexpr size_t SizeClassUnit = 16;
+		static constexpr size_t SizeClassCount = 16;
+
+		std::vector<Block> mBlocks;
+		std::array<FreeNode*, SizeClassCount> mFreeLists;
+		size_t mBlockSize;
+		size_t mCurrentBlock = 0;
+		size_t mOffset = 0;
+	};
+
+	/**
+	ScratchArenaから確保するSTL互換アロケータ
+	アリーナを指定しない場合は通常のヒープから確保します。
+	*/
+	template<typename T>
+	class ScratchAllocator
+	{
+	public:
+		using value_type = T;
+
+		/**
+		コンストラクタ
+		\param[in]	arena	確保に使うアリーナ（nullptrならヒープ）
+		*/
+		explicit ScratchAllocator(ScratchArena* arena = nullptr) noexcept;
+
+		/**
+		変換コンストラクタ
+		*/
+		template<typename U>
+		ScratchAllocator(const ScratchAllocator<U>& other) noexcept;
+
+		T* allocate(const size_t count);
+		void deallocate(T* pointer, const size_t count) noexcept;
+
+		/**
+		確保に使うアリーナを取得します
+		*/
+		ScratchArena* GetArena() const noexcept;
+
+	private:
+		ScratchArena* mArena;
+	};
+
+	template<typename T, typename U>
+	bool operator==(const ScratchAllocator<T>& l, const ScratchAllocator<U>& r) noexcept;
+
+	template<typename T, typename U>
+	bool operator!=(const ScratchAllocator<T>& l, const ScratchAllocator<U>& r) noexcept;
+}
+
+#include "ScratchArena.inl"
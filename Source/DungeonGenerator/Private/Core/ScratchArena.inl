@@ -0,0 +1,71 @@
+/**
+作業領域アリーナ インラインファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+#include <new>
+
+namespace dungeon
+{
+	inline size_t ScratchArena::GetBlockCount() const noexcept
+	{
+		return mBlocks.size();
+	}
+
+	inline size_t ScratchArena::SizeClass(const size_t size) noexcept
+	{
+		return (size + SizeClassUnit - 1) / SizeClassUnit - 1;
+	}
+
+	template<typename T>
+	inline ScratchAllocator<T>::ScratchAllocator(ScratchArena* arena) noexcept
+		: mArena(arena)
+	{
+	}
+
+	template<typename T>
+	template<typename U>
+	inline ScratchAllocator<T>::ScratchAllocator(const ScratchAllocator<U>& other) noexcept
+		: mArena(other.GetArena())
+	{
+	}
+
+	template<typename T>
+	inline T* ScratchAllocator<T>::allocate(const size_t count)
+	{
+		if (mArena)
+			return static_cast<T*>(mArena->Allocate(sizeof(T) * count, alignof(T)));
+		return static_cast<T*>(::operator new(sizeof(T) * count));
+	}
+
+	template<typename T>
+	inline void ScratchAllocator<T>::deallocate(T* pointer, const size_t count) noexcept
+	{
+		if (mArena)
+			mArena->Deallocate(pointer, sizeof(T) * count);
+		else
+			::operator delete(pointer);
+	}
+
+	template<typename T>
+	inline ScratchArena* ScratchAllocator<T>::GetArena() const noexcept
+	{
+		return mArena;
+	}
+
+	template<typename T, typename U>
+	inline bool operator==(const ScratchAllocator<T>& l, const ScratchAllocator<U>& r) noexcept
+	{
+		return l.GetArena() == r.GetArena();
+	}
+
+	template<typename T, typename U>
+	inline bool operator!=(const ScratchAllocator<T>& l, const ScratchAllocator<U>& r) noexcept
+	{
+		return l.GetArena() != r.GetArena();
+	}
+}
@@ -0,0 +1,177 @@
+/**
+経路探索コンテキスト ヘッダーファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+#include "AisleSearchMode.h"
+#include "ScratchArena.h"
+#include "SearchStatistics.h"
+#include <cstdint>
+#include <vector>
+
+namespace dungeon
+{
+	// 前方宣言
+	class ClusterGraph;
+	class GateCandidateCache;
+
+	/**
+	経路探索コンテキストクラス
+	一回の生成の間、全ての通路の門検索とA*で作業領域を共有します。
+	通路毎にResetで巻き戻すので、二本目以降の通路ではほとんどメモリ確保が発生しません。
+	*/
+	class SearchContext final
+	{
+	public:
+		/**
+		コンストラクタ
+		*/
+		SearchContext() noexcept = default;
+		SearchContext(const SearchContext&) = delete;
+		SearchContext& operator=(const SearchContext&) = delete;
+
+		/**
+		デストラクタ
+		*/
+		~SearchContext() = default;
+
+		/**
+		作業領域を巻き戻します
+		作業領域から確保したコンテナは全て破棄してから呼び出して下さい
+		*/
+		void Reset() noexcept;
+
+		/**
+		作業領域を取得します
+		*/
+		ScratchArena& GetArena() noexcept;
+
+		/**
+		探索中に参照したボクセルの記録を開始します
+		\param[out]	indices		参照したボクセルのインデックスを追加するコンテナ
+		*/
+		void BeginReadTracking(std::vector<size_t>& indices) noexcept;
+
+		/**
+		探索中に参照したボクセルの記録を終了します
+		*/
+		void EndReadTracking() noexcept;
+
+		/**
+		ボクセルの参照を記録します
+		記録中でなければ何もしません
+		\param[in]	index	ボクセルのインデックス
+		*/
+		void TrackRead(const size_t index);
+
+		/**
+		階層的経路探索のクラスタグラフを設定します
+		\param[in]	clusterGraph	クラスタグラフ（nullptrなら階層的経路探索をしない）
+		*/
+		void SetClusterGraph(ClusterGraph* clusterGraph) noexcept;
+
+		/**
+		階層的経路探索のクラスタグラフを取得します
+		*/
+		ClusterGraph* GetClusterGraph() const noexcept;
+
+		/**
+		部屋の外周にある門の候補を設定します
+		\param[in]	gateCandidates	門の候補（nullptrなら部屋の床を探索する）
+		*/
+		void SetGateCandidates(GateCandidateCache* gateCandidates) noexcept;
+
+		/**
+		部屋の外周にある門の候補を取得します
+		*/
+		GateCandidateCache* GetGateCandidates() const noexcept;
+
+		/**
+		探索範囲を制限する回廊を設定します
+		\param[in]	corridor	回廊を選んだクラスタグラフ（nullptrなら制限しない）
+		*/
+		void SetCorridor(const ClusterGraph* corridor) noexcept;
+
+		/**
+		探索範囲を制限する回廊を取得します
+		*/
+		const ClusterGraph* GetCorridor() const noexcept;
+
+		/**
+		通路の探索方法を設定します
+		\param[in]	mode				探索方法
+		\param[in]	heuristicsWeight	重み付きA*のヒューリスティックの重み
+		*/
+		void SetSearchMode(const AisleSearchMode mode, const float heuristicsWeight) noexcept;
+
+		/**
+		通路の探索方法を取得します
+		*/
+		AisleSearchMode GetSearchMode() const noexcept;
+
+		/**
+		重み付きA*のヒューリスティックの重みを取得します
+		*/
+		float GetHeuristicsWeight() const noexcept;
+
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		/**
+		通路毎の探索の統計をリセットします
+		*/
+		void BeginAisleStatistics() noexcept;
+
+		/**
+		探索の統計を加算します
+		\param[in]	statistics	探索の統計
+		*/
+		void AddStatistics(const SearchStatistics& statistics) noexcept;
+
+		/**
+		BeginAisleStatistics以降の探索の統計を取得します
+		*/
+		const SearchStatistics& GetAisleStatistics() const noexcept;
+
+		/**
+		探索の統計の累計を取得します
+		*/
+		const SearchStatistics& GetTotalStatistics() const noexcept;
+
+		/**
+		ボクセル毎にA*で展開した回数の記録を開始します
+		\param[in]	voxelCount	ボクセルの数
+		*/
+		void EnableHeatmap(const size_t voxelCount);
+
+		/**
+		A*で展開したボクセルを記録します
+		\param[in]	index	ボクセルのインデックス
+		*/
+		void RecordExpansion(const size_t index) noexcept;
+
+		/**
+		ボクセル毎にA*で展開した回数を取得します
+		*/
+		std::vector<uint32_t>& GetHeatmap() noexcept;
+#endif
+
+	private:
+		ScratchArena mArena;
+		std::vector<size_t>* mReadIndices = nullptr;
+		ClusterGraph* mClusterGraph = nullptr;
+		GateCandidateCache* mGateCandidates = nullptr;
+		const ClusterGraph* mCorridor = nullptr;
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		SearchStatistics mAisleStatistics;
+		SearchStatistics mTotalStatistics;
+		std::vector<uint32_t> mHeatmap;
+#endif
+		float mHeuristicsWeight = 1.f;
+		AisleSearchMode mSearchMode = AisleSearchMode::Standard;
+	};
+}
+
+#include "SearchContext.inl"
@@ -0,0 +1,123 @@
+/**
+経路探索コンテキスト インラインファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+
+namespace dungeon
+{
+	inline void SearchContext::Reset() noexcept
+	{
+		mArena.Reset();
+	}
+
+	inline ScratchArena& SearchContext::GetArena() noexcept
+	{
+		return mArena;
+	}
+
+	inline void SearchContext::BeginReadTracking(std::vector<size_t>& indices) noexcept
+	{
+		mReadIndices = &indices;
+	}
+
+	inline void SearchContext::EndReadTracking() noexcept
+	{
+		mReadIndices = nullptr;
+	}
+
+	inline void SearchContext::TrackRead(const size_t index)
+	{
+		if (mReadIndices)
+			mReadIndices->push_back(index);
+	}
+
+	inline void SearchContext::SetClusterGraph(ClusterGraph* clusterGraph) noexcept
+	{
+		mClusterGraph = clusterGraph;
+	}
+
+	inline ClusterGraph* SearchContext::GetClusterGraph() const noexcept
+	{
+		return mClusterGraph;
+	}
+
+	inline void SearchContext::SetGateCandidates(GateCandidateCache* gateCandidates) noexcept
+	{
+		mGateCandidates = gateCandidates;
+	}
+
+	inline GateCandidateCache* SearchContext::GetGateCandidates() const noexcept
+	{
+		return mGateCandidates;
+	}
+
+	inline void SearchContext::SetCorridor(const ClusterGraph* corridor) noexcept
+	{
+		mCorridor = corridor;
+	}
+
+	inline const ClusterGraph* SearchContext::GetCorridor() const noexcept
+	{
+		return mCorridor;
+	}
+
+	inline void SearchContext::SetSearchMode(const AisleSearchMode mode, const float heuristicsWeight) noexcept
+	{
+		mSearchMode = mode;
+		mHeuristicsWeight = heuristicsWeight;
+	}
+
+	inline AisleSearchMode SearchContext::GetSearchMode() const noexcept
+	{
+		return mSearchMode;
+	}
+
+	inline float SearchContext::GetHeuristicsWeight() const noexcept
+	{
+		return mHeuristicsWeight;
+	}
+
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+	inline void SearchContext::BeginAisleStatistics() noexcept
+	{
+		mAisleStatistics = SearchStatistics();
+	}
+
+	inline void SearchContext::AddStatistics(const SearchStatistics& statistics) noexcept
+	{
+		mAisleStatistics.Add(statistics);
+		mTotalStatistics.Add(statistics);
+	}
+
+	inline const SearchStatistics& SearchContext::GetAisleStatistics() const noexcept
+	{
+		return mAisleStatistics;
+	}
+
+	inline const SearchStatistics& SearchContext::GetTotalStatistics() const noexcept
+	{
+		return mTotalStatistics;
+	}
+
+	inline void SearchContext::EnableHeatmap(const size_t voxelCount)
+	{
+		mHeatmap.assign(voxelCount, 0);
+	}
+
+	inline void SearchContext::RecordExpansion(const size_t index) noexcept
+	{
+		if (index < mHeatmap.size())
+			++mHeatmap[index];
+	}
+
+	inline std::vector<uint32_t>& SearchContext::GetHeatmap() noexcept
+	{
+		return mHeatmap;
+	}
+#endif
+}
@@ -0,0 +1,58 @@
+/**
+経路探索の統計 ヘッダーファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+
+// シッピングビルド以外では経路探索の統計とヒートマップを記録します
+#if !defined(UE_BUILD_SHIPPING) || UE_BUILD_SHIPPING == 0
+#define DUNGEON_GENERATOR_SEARCH_STATISTICS 1
+#else
+#define DUNGEON_GENERATOR_SEARCH_STATISTICS 0
+#endif
+
+namespace dungeon
+{
+	/**
+	経路探索の統計
+	*/
+	struct SearchStatistics final
+	{
+		//! A*で開いたノードの数
+		size_t mOpenedNodeCount = 0;
+		//! A*で閉じたノードの数
+		size_t mClosedNodeCount = 0;
+		//! A*のオープンリストの最大の大きさ
+		size_t mPeakOpenNodeCount = 0;
+		//! 階段を置けるか調べた回数
+		size_t mStairProbeCount = 0;
+		//! 使用中の階段と重なって開けなかったノードの数
+		size_t mRejectedReservationCount = 0;
+		//! 門の検索で開いたノードの数
+		size_t mGateOpenedNodeCount = 0;
+		//! 門の検索で閉じたノードの数
+		size_t mGateClosedNodeCount = 0;
+
+		/**
+		統計を加算します
+		オープンリストの最大の大きさは大きい方を残します
+		\param[in]	other	加算する統計
+		*/
+		void Add(const SearchStatistics& other) noexcept
+		{
+			mOpenedNodeCount += other.mOpenedNodeCount;
+			mClosedNodeCount += other.mClosedNodeCount;
+			mPeakOpenNodeCount = std::max(mPeakOpenNodeCount, other.mPeakOpenNodeCount);
+			mStairProbeCount += other.mStairProbeCount;
+			mRejectedReservationCount += other.mRejectedReservationCount;
+			mGateOpenedNodeCount += other.mGateOpenedNodeCount;
+			mGateClosedNodeCount += other.mGateClosedNodeCount;
+		}
+	};
+}
@@ -7,13 +7,17 @@ All Rights Reserved.
 */
 
 #include "Voxel.h"
+#include "ClusterGraph.h"
 #include "GenerateParameter.h"
+#include "GateCandidateCache.h"
 #include "GateFinder.h"
 #include "PathFinder.h"
 #include "PathGoalCondition.h"
+#include "SearchContext.h"
 #include "Debug/BuildInfomation.h"
 #include "Debug/Debug.h"
 #include "Math/Math.h"
+#include <algorithm>
 #include <array>
 
 #if WITH_EDITOR && JENKINS_FOR_DEVELOP
@@ -23,12 +27,176 @@ All Rights Reserved.
 
 namespace dungeon
 {
+	namespace
+	{
+		/**
+		ノードに隣接するノードを開きます
+		\param[in]	pathFinder		パス検索
+		\param[in]	key				展開するノードのキー
+		\param[in]	nodeType		展開するノードの種類
+		\param[in]	cost			展開するノードのコスト
+		\param[in]	location		展開するノードの位置
+		\param[in]	direction		展開するノードの方向
+		\param[in]	searchDirection	展開するノードから検索可能な方向
+		\param[in]	heuristicsGoal	ヒューリスティックを計算するゴール位置
+		\param[in]	isEmpty			空きグリッドか調べる関数
+		\param[in]	isEmptyStairs	階段を置く三つのグリッドが空いているか調べる関数
+		\param[in]	isReachedGoal	ゴール範囲に含まれるか調べる関数（ゴール範囲には階段を置かない）
+		\param[in]	isReachedTarget	探索の目的地か調べる関数（空きグリッドでなくても進入できる）
+		*/
+		template<typename IsEmpty, typename IsEmptyStairs, typename IsReachedGoal, typename IsReachedTarget>
+		void OpenAisleNodes(PathFinder& pathFinder, const uint64_t key, const PathFinder::NodeType nodeType, const uint32_t cost, const FIntVector& location, const Direction direction, const PathFinder::SearchDirection searchDirection, const FIntVector& heuristicsGoal, const IsEmpty& isEmpty, const IsEmptyStairs& isEmptyStairs, const IsReachedGoal& isReachedGoal, const IsReachedTarget& isReachedTarget) noexcept
+		{
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+			SearchStatistics& statistics = pathFinder.GetStatistics();
+#endif
+
+			// 水平方向へ探索
+			for (auto i = Direction::Begin(); i != Direction::End(); ++i)
+			{
+				if (
+					searchDirection == PathFinder::SearchDirection::Any ||
+					searchDirection == static_cast<PathFinder::SearchDirection>(std::distance(Direction::Begin(), i)))
+				{
+					const FIntVector openLocation = location + *i;
+					if (pathFinder.IsUsingOpenNode(openLocation) == false)
+					{
+						if (isEmpty(openLocation) || isReachedTarget(openLocation))
+						{
+							const Direction openDirection(static_cast<Direction::Index>(std::distance(Direction::Begin(), i)));
+							pathFinder.Open(key, PathFinder::NodeType::Aisle, cost + 1, openLocation, heuristicsGoal, openDirection, PathFinder::SearchDirection::Any);
+						}
+					}
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+					else
+					{
+						++statistics.mRejectedReservationCount;
+					}
+#endif
+				}
+			}
+
+			// 垂直方向へ探索
+			if (nodeType == PathFinder::NodeType::Aisle)
+			{
+				// 上
+				const FIntVector upstairsOpenLocationU = location + FIntVector(0, 0, 1);
+				const FIntVector upstairsOpenLocationF = location + direction.GetVector();
+				const FIntVector upstairsOpenLocationUF = upstairsOpenLocationF + FIntVector(0, 0, 1);
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+				++statistics.mStairProbeCount;
+#endif
+				if (
+					isEmptyStairs(location, direction, 1) &&
+					isReachedGoal(upstairsOpenLocationU) == false &&
+					isReachedGoal(upstairsOpenLocationF) == false &&
+					isReachedGoal(upstairsOpenLocationUF) == false)
+				{
+					if (pathFinder.IsUsingOpenNode(upstairsOpenLocationU) == false && pathFinder.IsUsingOpenNode(upstairsOpenLocationF) == false)
+					{
+						pathFinder.Open(key, PathFinder::NodeType::Upstairs, cost + 1, upstairsOpenLocationUF, heuristicsGoal, direction, PathFinder::Cast(direction));
+						pathFinder.ReserveOpenNode(upstairsOpenLocationUF, upstairsOpenLocationU, upstairsOpenLocationF);
+					}
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+					else
+					{
+						++statistics.mRejectedReservationCount;
+					}
+#endif
+				}
+
+				// 下
+				const FIntVector downstairsOpenLocationD = location + FIntVector(0, 0, -1);
+				const FIntVector downstairsOpenLocationF = location + direction.GetVector();
+				const FIntVector downstairsOpenLocationDF = downstairsOpenLocationF + FIntVector(0, 0, -1);
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+				++statistics.mStairProbeCount;
+#endif
+				if (
+					isEmptyStairs(location, direction, -1) &&
+					isReachedGoal(downstairsOpenLocationD) == false &&
+					isReachedGoal(downstairsOpenLocationF) == false &&
+					isReachedGoal(downstairsOpenLocationDF) == false)
+				{
+					if (pathFinder.IsUsingOpenNode(downstairsOpenLocationD) == false && pathFinder.IsUsingOpenNode(downstairsOpenLocationF) == false)
+					{
+						pathFinder.Open(key, PathFinder::NodeType::Downstairs, cost + 1, downstairsOpenLocationDF, heuristicsGoal, direction, PathFinder::Cast(direction));
+						pathFinder.ReserveOpenNode(downstairsOpenLocationDF, downstairsOpenLocationD, downstairsOpenLocationF);
+					}
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+					else
+					{
+						++statistics.mRejectedReservationCount;
+					}
+#endif
+				}
+			}
+		}
+
+		/**
+		確定した経路をグリッドに書き込む形式に変換して追加します
+		\param[out]	route		追加先の経路
+		\param[in]	pathFinder	経路を確定したパス検索
+		\param[in]	reverse		trueならば逆向きに探索した経路として、並びと向きを反転する
+		*/
+		void AppendRoute(Voxel::Route& route, const PathFinder& pathFinder, const bool reverse) noexcept
+		{
+			const size_t begin = route.size();
+			pathFinder.Path([&route](PathFinder::NodeType nodeType, const FIntVector& location, Direction direction)
+				{
+					Grid::Type cellType;
+					switch (nodeType)
+					{
+					case PathFinder::NodeType::Space:
+						cellType = Grid::Type::Atrium;
+						break;
+
+					case PathFinder::NodeType::Downstairs:
+						cellType = Grid::Type::Slope;
+						direction.SetInverse();
+						break;
+
+					case PathFinder::NodeType::Upstairs:
+						cellType = Grid::Type::Slope;
+						break;
+
+					case PathFinder::NodeType::Gate:
+						cellType = Grid::Type::Gate;
+						break;
+
+					case PathFinder::NodeType::Aisle:
+						cellType = Grid::Type::Aisle;
+						break;
+
+					default:
+						return;
+					}
+					route.push_back({ location, cellType, direction });
+				}
+			);
+
+			if (reverse)
+			{
+				// 斜面の向きは上り下りで変わらないので、それ以外の向きだけ反転する
+				std::reverse(route.begin() + begin, route.end());
+				for (auto node = route.begin() + begin; node != route.end(); ++node)
+				{
+					if (node->mType != Grid::Type::Slope)
+						node->mDirection.SetInverse();
+				}
+			}
+		}
+	}
+
 	Voxel::Voxel(const GenerateParameter& parameter) noexcept
-		: mGrids(std::make_unique<Grid[]>(static_cast<size_t>(parameter.GetWidth()) * parameter.GetDepth() * parameter.GetHeight()))
+		: mStorage(parameter.GetWidth(), parameter.GetDepth(), parameter.GetHeight(), parameter.GetVoxelLayout())
 		, mWidth(parameter.GetWidth())
 		, mDepth(parameter.GetDepth())
 		, mHeight(parameter.GetHeight())
+		, mEmptyBitsLayerWords((static_cast<size_t>(mWidth) * mDepth + 63) / 64)
 	{
+		mEmptyBits = std::make_unique<uint64_t[]>(mEmptyBitsLayerWords * mHeight);
+		RebuildEmptyBits();
 	}
 
 	void Voxel::Rectangle(const FIntVector& min, const FIntVector& max, const Grid& fillGrid, const Grid& floorGrid) noexcept
@@ -48,26 +216,16 @@ namespace dungeon
 		if (min_.Z > max_.Z) std::swap(min_.Z, max_.Z);
 
 		// 床を塗りつぶす
-		for (int32_t y = min_.Y; y < max_.Y; ++y)
-		{
-			for (int32_t x = min_.X; x < max_.X; ++x)
-			{
-				const size_t minIndex = Index(x, y, min_.Z);
-				mGrids.get()[minIndex] = floorGrid;
-			}
-		}
+		const FIntVector floorMax(max_.X, max_.Y, std::min(min_.Z + 1, max_.Z));
+		mStorage.Fill(min_, floorMax, floorGrid);
+		UpdateEmptyBits(min_, floorMax, floorGrid);
 
 		// 中を塗りつぶす
-		for (int32_t z = min_.Z + 1; z < max_.Z; ++z)
+		if (min_.Z + 1 < max_.Z)
 		{
-			for (int32_t y = min_.Y; y < max_.Y; ++y)
-			{
-				for (int32_t x = min_.X; x < max_.X; ++x)
-				{
-					const size_t index = Index(x, y, z);
-					mGrids.get()[index] = fillGrid;
-				}
-			}
+			const FIntVector fillMin(min_.X, min_.Y, min_.Z + 1);
+			mStorage.Fill(fillMin, max_, fillGrid);
+			UpdateEmptyBits(fillMin, max_, fillGrid);
 		}
 	}
 
@@ -87,25 +245,74 @@ namespace dungeon
 		if (min_.Y > max_.Y) std::swap(min_.Y, max_.Y);
 		if (min_.Z > max_.Z) std::swap(min_.Z, max_.Z);
 
-		for (int32_t z = min_.Z; z < max_.Z; ++z)
+		// メッシュ生成禁止フラグは空きグリッドの判定に影響しないのでビット列は更新しない
+		mStorage.Transform(min_, max_, [noRoofMeshGeneration, noFloorMeshGeneration](Grid& grid)
+			{
+				grid.SetNoMeshGeneration(noRoofMeshGeneration, noFloorMeshGeneration);
+			}
+		);
+	}
+
+	void Voxel::UpdateEmptyBits(const FIntVector& min, const FIntVector& max, const Grid& grid) noexcept
+	{
+		if (min.X >= max.X || min.Y >= max.Y)
+			return;
+
+		const bool empty = grid.GetType() == Grid::Type::Empty;
+		for (int32_t z = min.Z; z < max.Z; ++z)
 		{
-			for (int32_t y = min_.Y; y < max_.Y; ++y)
+			// 幅全体を覆う場合は一つの連続したビット列になる
+			if (min.X == 0 && max.X == static_cast<int32_t>(mWidth))
 			{
-				for (int32_t x = min_.X; x < max_.X; ++x)
-				{
-					const size_t index = Index(x, y, z);
-					mGrids.get()[index].SetNoMeshGeneration(noRoofMeshGeneration, noFloorMeshGeneration);
-				}
+				FillEmptyBitRun(EmptyBitIndex(0, min.Y, z), static_cast<size_t>(max.Y - min.Y) * mWidth, empty);
+				continue;
 			}
+
+			for (int32_t y = min.Y; y < max.Y; ++y)
+				FillEmptyBitRun(EmptyBitIndex(min.X, y, z), max.X - min.X, empty);
 		}
 	}
 
-	bool Voxel::SearchGateLocation(FIntVector& result, const FIntVector& start, const FIntVector& goal, const PathGoalCondition& goalCondition, const Identifier& identifier) noexcept
+	void Voxel::FillEmptyBitRun(const size_t begin, const size_t count, const bool empty) noexcept
 	{
-		GateFinder gateFinder(start, goal);
+		const size_t end = begin + count;
+		size_t word = begin >> 6;
+		const size_t lastWord = (end - 1) >> 6;
+		const uint64_t headMask = ~static_cast<uint64_t>(0) << (begin & 63);
+		const uint64_t tailMask = ~static_cast<uint64_t>(0) >> (63 - ((end - 1) & 63));
+
+		if (word == lastWord)
+		{
+			const uint64_t mask = headMask & tailMask;
+			mEmptyBits[word] = empty ? (mEmptyBits[word] | mask) : (mEmptyBits[word] & ~mask);
+			return;
+		}
+
+		mEmptyBits[word] = empty ? (mEmptyBits[word] | headMask) : (mEmptyBits[word] & ~headMask);
+		const uint64_t fill = empty ? ~static_cast<uint64_t>(0) : 0;
+		for (++word; word < lastWord; ++word)
+			mEmptyBits[word] = fill;
+		mEmptyBits[lastWord] = empty ? (mEmptyBits[lastWord] | tailMask) : (mEmptyBits[lastWord] & ~tailMask);
+	}
+
+	bool Voxel::SearchGateLocation(FIntVector& result, const FIntVector& start, const FIntVector& goal, const PathGoalCondition& goalCondition, const Identifier& identifier, SearchContext& context) const noexcept
+	{
+		// 前回の検索の作業領域を再利用する
+		context.Reset();
+
+		// 部屋の外周にある門の候補から選ぶ
+		if (const GateCandidateCache* gateCandidates = context.GetGateCandidates())
+		{
+			if (gateCandidates->Find(result, start, goal, goalCondition, context))
+				return true;
+		}
 
+		// 候補から選べなければ床を探索する
+		GateFinder gateFinder(start, goal, context.GetArena());
+
+		bool found = false;
 		FIntVector nextLocation;
-		while (gateFinder.Pop(nextLocation))
+		while (!found && gateFinder.Pop(nextLocation))
 		{
 			for (auto i = Direction::Begin(); i != Direction::End(); ++i)
 			{
@@ -113,17 +320,20 @@ namespace dungeon
 				if (IsReachedGoal(openLocation, goal.Z, goalCondition))
 				{
 					result = nextLocation;
-					return true;
+					found = true;
+					break;
 				}
 				else if (Contain(openLocation))
 				{
 					const size_t index = Index(openLocation);
-					const auto& grid = mGrids.get()[index];
+					const auto& grid = mStorage.Get(openLocation.X, openLocation.Y, openLocation.Z);
+					context.TrackRead(index);
 
 					if (grid.GetType() == Grid::Type::Empty)
 					{
 						result = nextLocation;
-						return true;
+						found = true;
+						break;
 					}
 					else if (grid.GetType() == Grid::Type::Deck)
 					{
@@ -134,10 +344,16 @@ namespace dungeon
 			}
 		}
 
-		return false;
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		SearchStatistics statistics;
+		gateFinder.AddStatistics(statistics);
+		context.AddStatistics(statistics);
+#endif
+
+		return found;
 	}
 
-	bool Voxel::Aisle(const FIntVector& start, const FIntVector& idealGoal, const PathGoalCondition& goalCondition, const Identifier& identifier) noexcept
+	bool Voxel::Aisle(Route& route, const FIntVector& start, const FIntVector& idealGoal, const PathGoalCondition& goalCondition, const Identifier& identifier, SearchContext& context) noexcept
 	{
 		if (!goalCondition.Contains(idealGoal))
 		{
@@ -146,8 +362,60 @@ namespace dungeon
 			return false;
 		}
 
+		if (!FindAisle(route, start, idealGoal, goalCondition, context))
+		{
+			DUNGEON_GENERATOR_ERROR(TEXT("Voxel: 経路探索に失敗しました (%d,%d,%d)-(%d,%d,%d)"), start.X, start.Y, start.Z, idealGoal.X, idealGoal.Y, idealGoal.Z);
+			return false;
+		}
+
+#if defined(DEBUG_SHOW_DEVELOP_LOG)
+		DUNGEON_GENERATOR_LOG(TEXT("経路探索に成功しました (%d,%d,%d)-(%d,%d,%d)"), start.X, start.Y, start.Z, route.back().mLocation.X, route.back().mLocation.Y, route.back().mLocation.Z);
+#endif
+
+		WriteAisle(route, identifier);
+		return true;
+	}
+
+	bool Voxel::FindAisle(Route& route, const FIntVector& start, const FIntVector& idealGoal, const PathGoalCondition& goalCondition, SearchContext& context) const noexcept
+	{
+		route.clear();
+
+		if (!goalCondition.Contains(idealGoal))
+			return false;
+
+		// 両側からの探索に失敗したら始点からの探索に切り替える
+		if (context.GetSearchMode() == AisleSearchMode::Bidirectional)
+		{
+			if (FindAisleBidirectionally(route, start, idealGoal, goalCondition, context))
+				return true;
+			route.clear();
+		}
+
+		return FindAisleForward(route, start, idealGoal, goalCondition, context);
+	}
+
+	bool Voxel::FindAisleForward(Route& route, const FIntVector& start, const FIntVector& idealGoal, const PathGoalCondition& goalCondition, SearchContext& context) const noexcept
+	{
+		// 前回の検索の作業領域を再利用する
+		context.Reset();
+
+		const auto isEmpty = [this, &context](const FIntVector& location)
+			{
+				return IsEmpty(location, context);
+			};
+		const auto isEmptyStairs = [this, &context](const FIntVector& location, const Direction direction, const int32_t altitude)
+			{
+				return IsEmptyStairs(location, direction, altitude, context);
+			};
+		const auto isReachedGoal = [&idealGoal, &goalCondition](const FIntVector& location)
+			{
+				return IsReachedGoal(location, idealGoal.Z, goalCondition);
+			};
+
 		// パス検索開始
-		PathFinder pathFinder;
+		PathFinder pathFinder(context.GetArena());
+		if (context.GetSearchMode() != AisleSearchMode::Standard)
+			pathFinder.SetHeuristicsWeight(context.GetHeuristicsWeight());
 		pathFinder.Start(start, idealGoal, PathFinder::SearchDirection::Any);
 
 		// 最も有望な位置を取得します
@@ -159,8 +427,12 @@ namespace dungeon
 		PathFinder::SearchDirection nextSearchDirection;
 		while (pathFinder.Pop(nextKey, nextNodeType, nextCost, nextLocation, nextDirection, nextSearchDirection))
 		{
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+			context.RecordExpansion(Index(nextLocation));
+#endif
+
 			// ゴールに到達？
-			if (IsReachedGoal(nextLocation, idealGoal.Z, goalCondition))
+			if (isReachedGoal(nextLocation))
 			{
 				if (nextNodeType == PathFinder::NodeType::Aisle && nextSearchDirection == PathFinder::SearchDirection::Any)
 					break;
@@ -168,141 +440,203 @@ namespace dungeon
 					continue;
 			}
 
-			// 水平方向へ探索
-			for (auto i = Direction::Begin(); i != Direction::End(); ++i)
+			OpenAisleNodes(pathFinder, nextKey, nextNodeType, nextCost, nextLocation, nextDirection, nextSearchDirection, idealGoal, isEmpty, isEmptyStairs, isReachedGoal, isReachedGoal);
+		}
+
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		context.AddStatistics(pathFinder.GetStatistics());
+#endif
+
+		if (!goalCondition.Contains(nextLocation))
+			return false;
+
+		// nextLocationが実際に到達した場所
+		if (!pathFinder.Commit(nextLocation))
+			return false;
+
+		// グリッドに書き込む形式に変換します
+		AppendRoute(route, pathFinder, false);
+		return true;
+	}
+
+	bool Voxel::FindAisleBidirectionally(Route& route, const FIntVector& start, const FIntVector& idealGoal, const PathGoalCondition& goalCondition, SearchContext& context) const noexcept
+	{
+		// 前回の検索の作業領域を再利用する
+		context.Reset();
+
+		const auto isEmpty = [this, &context](const FIntVector& location)
 			{
-				if (
-					nextSearchDirection == PathFinder::SearchDirection::Any ||
-					nextSearchDirection == static_cast<PathFinder::SearchDirection>(std::distance(Direction::Begin(), i)))
-				{
-					const FIntVector openLocation = nextLocation + *i;
-					if (pathFinder.IsUsingOpenNode(openLocation) == false)
+				return IsEmpty(location, context);
+			};
+		const auto isEmptyStairs = [this, &context](const FIntVector& location, const Direction direction, const int32_t altitude)
+			{
+				return IsEmptyStairs(location, direction, altitude, context);
+			};
+		const auto isReachedGoal = [&idealGoal, &goalCondition](const FIntVector& location)
+			{
+				return IsReachedGoal(location, idealGoal.Z, goalCondition);
+			};
+		const auto isReachedStart = [&start](const FIntVector& location)
+			{
+				return location == start;
+			};
+
+		// 始点からの探索
+		PathFinder forward(context.GetArena());
+		forward.SetHeuristicsWeight(context.GetHeuristicsWeight());
+		forward.Start(start, idealGoal, PathFinder::SearchDirection::Any);
+
+		/*
+		ゴール範囲の入口からの探索
+		階段を置く条件は進行方向に対して対称なので、同じ規則で逆向きに探索できます
+		*/
+		PathFinder backward(context.GetArena());
+		backward.SetHeuristicsWeight(context.GetHeuristicsWeight());
+		const FIntRect& rect = goalCondition.Get();
+		for (int32_t y = rect.Min.Y; y < rect.Max.Y; ++y)
+		{
+			for (int32_t x = rect.Min.X; x < rect.Max.X; ++x)
+			{
+				const FIntVector location(x, y, idealGoal.Z);
+				const bool entrance = std::any_of(Direction::Begin(), Direction::End(), [&](const FIntVector& offset)
 					{
-						if (IsEmpty(openLocation) || IsReachedGoal(openLocation, idealGoal.Z, goalCondition))
-						{
-							const Direction direction(static_cast<Direction::Index>(std::distance(Direction::Begin(), i)));
-							pathFinder.Open(nextKey, PathFinder::NodeType::Aisle, nextCost + 1, openLocation, idealGoal, direction, PathFinder::SearchDirection::Any);
-						}
+						const FIntVector outside = location + offset;
+						return !goalCondition.Contains(outside) && (isReachedStart(outside) || isEmpty(outside));
 					}
-				}
+				);
+				if (entrance)
+					backward.Start(location, start, PathFinder::SearchDirection::Any);
 			}
+		}
 
-			// 垂直方向へ探索
-			if (nextNodeType == PathFinder::NodeType::Aisle)
-			{
-				// 上
-				const FIntVector upstairsOpenLocationU = nextLocation + FIntVector(0, 0, 1);
-				const FIntVector upstairsOpenLocationF = nextLocation + nextDirection.GetVector();
-				const FIntVector upstairsOpenLocationUF = upstairsOpenLocationF + FIntVector(0, 0, 1);
-				if (
-					IsReachedGoal(upstairsOpenLocationU, idealGoal.Z, goalCondition) == false && IsEmpty(upstairsOpenLocationU) && pathFinder.IsUsingOpenNode(upstairsOpenLocationU) == false &&
-					IsReachedGoal(upstairsOpenLocationF, idealGoal.Z, goalCondition) == false && IsEmpty(upstairsOpenLocationF) && pathFinder.IsUsingOpenNode(upstairsOpenLocationF) == false &&
-					IsReachedGoal(upstairsOpenLocationUF, idealGoal.Z, goalCondition) == false && IsEmpty(upstairsOpenLocationUF))
-				{
-					pathFinder.Open(nextKey, PathFinder::NodeType::Upstairs, nextCost + 1, upstairsOpenLocationUF, idealGoal, nextDirection, PathFinder::Cast(nextDirection));
+		uint64_t nextKey;
+		PathFinder::NodeType nextNodeType;
+		uint32_t nextCost;
+		FIntVector nextLocation;
+		Direction nextDirection;
+		PathFinder::SearchDirection nextSearchDirection;
 
+		// 交互に展開して、同じ通路ノードを両側が閉じたら出会ったとみなす
+		enum class Result : uint8_t
+		{
+			Searching,
+			Failed,
+			ReachedByForward,
+			ReachedByBackward,
+			Met
+		};
+		Result result = Result::Searching;
+		bool forwardTurn = true;
+		while (result == Result::Searching)
+		{
+			PathFinder& pathFinder = forwardTurn ? forward : backward;
+			const PathFinder& opposite = forwardTurn ? backward : forward;
+			if (!pathFinder.Pop(nextKey, nextNodeType, nextCost, nextLocation, nextDirection, nextSearchDirection))
+			{
+				result = Result::Failed;
+				break;
+			}
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+			context.RecordExpansion(Index(nextLocation));
+#endif
 
-					auto useNode = std::make_shared<PathNodeSwitcher::Node>();
-					useNode->Add(PathFinder::Hash(upstairsOpenLocationU));
-					useNode->Add(PathFinder::Hash(upstairsOpenLocationF));
-					pathFinder.ReserveOpenNode(upstairsOpenLocationUF, useNode);
+			const bool isAisle = nextNodeType == PathFinder::NodeType::Aisle && nextSearchDirection == PathFinder::SearchDirection::Any;
+			if (forwardTurn)
+			{
+				if (isReachedGoal(nextLocation))
+				{
+					if (isAisle)
+						result = Result::ReachedByForward;
 				}
-
-				// 下
-				const FIntVector downstairsOpenLocationD = nextLocation + FIntVector(0, 0, -1);
-				const FIntVector downstairsOpenLocationF = nextLocation + nextDirection.GetVector();
-				const FIntVector downstairsOpenLocationDF = downstairsOpenLocationF + FIntVector(0, 0, -1);
-				if (
-					IsReachedGoal(downstairsOpenLocationD, idealGoal.Z, goalCondition) == false && IsEmpty(downstairsOpenLocationD) && pathFinder.IsUsingOpenNode(downstairsOpenLocationD) == false &&
-					IsReachedGoal(downstairsOpenLocationF, idealGoal.Z, goalCondition) == false && IsEmpty(downstairsOpenLocationF) && pathFinder.IsUsingOpenNode(downstairsOpenLocationF) == false &&
-					IsReachedGoal(downstairsOpenLocationDF, idealGoal.Z, goalCondition) == false && IsEmpty(downstairsOpenLocationDF))
+				else if (isAisle && opposite.IsClosed(nextLocation, PathFinder::NodeType::Aisle))
 				{
-					pathFinder.Open(nextKey, PathFinder::NodeType::Downstairs, nextCost + 1, downstairsOpenLocationDF, idealGoal, nextDirection, PathFinder::Cast(nextDirection));
-
-
-					auto useNode = std::make_shared<PathNodeSwitcher::Node>();
-					useNode->Add(PathFinder::Hash(downstairsOpenLocationD));
-					useNode->Add(PathFinder::Hash(upstairsOpenLocationF));
-					pathFinder.ReserveOpenNode(downstairsOpenLocationDF, useNode);
+					result = Result::Met;
+				}
+				else
+				{
+					OpenAisleNodes(forward, nextKey, nextNodeType, nextCost, nextLocation, nextDirection, nextSearchDirection, idealGoal, isEmpty, isEmptyStairs, isReachedGoal, isReachedGoal);
+				}
+			}
+			else
+			{
+				if (isReachedStart(nextLocation))
+				{
+					if (isAisle)
+						result = Result::ReachedByBackward;
+				}
+				else if (isAisle && opposite.IsClosed(nextLocation, PathFinder::NodeType::Aisle))
+				{
+					result = Result::Met;
+				}
+				else
+				{
+					OpenAisleNodes(backward, nextKey, nextNodeType, nextCost, nextLocation, nextDirection, nextSearchDirection, start, isEmpty, isEmptyStairs, isReachedGoal, isReachedStart);
 				}
 			}
-		}
 
-		if (!goalCondition.Contains(nextLocation))
-		{
-			DUNGEON_GENERATOR_ERROR(TEXT("Voxel: 経路探索に失敗しました (%d,%d,%d)-(%d,%d,%d)"), start.X, start.Y, start.Z, idealGoal.X, idealGoal.Y, idealGoal.Z);
-			return false;
+			forwardTurn = !forwardTurn;
 		}
 
-		// nextLocationが実際に到達した場所
-		if (!pathFinder.Commit(nextLocation))
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+		context.AddStatistics(forward.GetStatistics());
+		context.AddStatistics(backward.GetStatistics());
+#endif
+
+		switch (result)
 		{
-			DUNGEON_GENERATOR_ERROR(TEXT("Voxel: 経路の生成に失敗しました (%d,%d,%d)-(%d,%d,%d)"), start.X, start.Y, start.Z, idealGoal.X, idealGoal.Y, idealGoal.Z);
+		case Result::ReachedByForward:
+			if (!forward.Commit(nextLocation))
+				return false;
+			AppendRoute(route, forward, false);
+			return true;
+
+		case Result::ReachedByBackward:
+			if (!backward.Commit(nextLocation))
+				return false;
+			AppendRoute(route, backward, true);
+			return true;
+
+		case Result::Met:
+			break;
+
+		default:
 			return false;
 		}
 
-#if defined(DEBUG_SHOW_DEVELOP_LOG)
-		DUNGEON_GENERATOR_LOG(TEXT("経路探索に成功しました (%d,%d,%d)-(%d,%d,%d)"), start.X, start.Y, start.Z, nextLocation.X, nextLocation.Y, nextLocation.Z);
-#endif
+		// 出会った位置で両側の経路をつなぐ
+		if (!forward.Commit(nextLocation) || !backward.Commit(nextLocation))
+			return false;
+		AppendRoute(route, forward, false);
+		route.back().mType = Grid::Type::Aisle;
+		const size_t meetingIndex = route.size();
+		AppendRoute(route, backward, true);
+		route.erase(route.begin() + meetingIndex);
+
+		// 両側の経路（階段の空間を含む）が重なっていたら失敗
+		std::vector<size_t, ScratchAllocator<size_t>> indices{ ScratchAllocator<size_t>(&context.GetArena()) };
+		indices.reserve(route.size());
+		for (const RouteNode& node : route)
+			indices.push_back(Index(node.mLocation));
+		std::sort(indices.begin(), indices.end());
+		return std::adjacent_find(indices.begin(), indices.end()) == indices.end();
+	}
 
-		// パスをグリッドに反映します
+	void Voxel::WriteAisle(const Route& route, const Identifier& identifier) noexcept
+	{
+		for (const RouteNode& node : route)
 		{
-			pathFinder.Path([this, &identifier](PathFinder::NodeType nodeType, const FIntVector& location, Direction direction)
-				{
-					Grid::Type cellType;
-					switch (nodeType)
-					{
-					case PathFinder::NodeType::Space:
-						cellType = Grid::Type::Atrium;
-						break;
-
-					case PathFinder::NodeType::Downstairs:
-						cellType = Grid::Type::Slope;
-						direction.SetInverse();
-						break;
-
-					case PathFinder::NodeType::Upstairs:
-						cellType = Grid::Type::Slope;
-						break;
-
-					case PathFinder::NodeType::Gate:
-						cellType = Grid::Type::Gate;
-						break;
+			Grid grid = mStorage.Get(node.mLocation.X, node.mLocation.Y, node.mLocation.Z);
 
-					case PathFinder::NodeType::Aisle:
-						cellType = Grid::Type::Aisle;
-						break;
-
-					default:
-						return;
-					}
-					const size_t index = Index(location);
-					Grid& grid = mGrids.get()[index];
-
-					// 識別子が無効なら通路
-					if (grid.IsInvalidIdentifier())
-					{
-						grid.SetIdentifier(identifier.Get());
-					}
-#if 0
-					// 識別子が有効なら開始位置と終了位置
-					else
-					{
-						if (cellType == Grid::Type::Atrium || cellType == Grid::Type::Slope)
-						{
-							int i = 0;
-							int k = 0;
-						}
-
-						grid.SetType(Grid::Type::Gate);
-					}
-#endif
-					grid.SetType(cellType);
-					grid.SetDirection(direction);
-				}
-			);
+			// 識別子が無効なら通路
+			if (grid.IsInvalidIdentifier())
+			{
+				grid.SetIdentifier(identifier.Get());
+			}
+			grid.SetType(node.mType);
+			grid.SetDirection(node.mDirection);
+			mStorage.Set(node.mLocation.X, node.mLocation.Y, node.mLocation.Z, grid);
+			UpdateEmptyBit(node.mLocation.X, node.mLocation.Y, node.mLocation.Z, grid);
 		}
-		return true;
 	}
 
 	size_t Voxel::Index(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept
@@ -323,24 +657,22 @@ namespace dungeon
 		return index;
 	}
 
-	const Grid& Voxel::Get(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept
+	Grid Voxel::Get(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept
 	{
 		if (mWidth <= x || mDepth <= y || mHeight <= z)
 		{
-			static const Grid outOfBounds(Grid::Type::OutOfBounds);
-			return outOfBounds;
+			return Grid(Grid::Type::OutOfBounds);
 		}
 
-		const size_t index = Index(x, y, z);
-		return mGrids.get()[index];
+		return mStorage.Get(x, y, z);
 	}
 
 	void Voxel::Set(const uint32_t x, const uint32_t y, const uint32_t z, const Grid& grid) noexcept
 	{
 		if (x < mWidth && y < mDepth && z < mHeight)
 		{
-			const size_t index = Index(x, y, z);
-			mGrids.get()[index] = grid;
+			mStorage.Set(x, y, z, grid);
+			UpdateEmptyBit(x, y, z, grid);
 		}
 	}
 
@@ -352,62 +684,70 @@ namespace dungeon
 			(0 <= location.Z && location.Z < static_cast<int32_t>(mHeight));
 	}
 
-	Grid& Voxel::operator[](const size_t index) noexcept
+	Grid Voxel::operator[](const size_t index) const noexcept
 	{
 		check(index < static_cast<size_t>(mWidth)* mDepth* mHeight);
-		return mGrids.get()[index];
+		return mStorage.Get(index);
 	}
 
-	const Grid& Voxel::operator[](const size_t index) const noexcept
+	bool Voxel::IsEmpty(const FIntVector& location, SearchContext& context) const noexcept
 	{
-		check(index < static_cast<size_t>(mWidth)* mDepth* mHeight);
-		return mGrids.get()[index];
-	}
+		// 範囲内？
+		if (!Contain(location))
+			return false;
 
-	void Voxel::Each(std::function<bool(const FIntVector& location, Grid& grid)> func) noexcept
-	{
-		for (uint32_t z = 0; z < mHeight; ++z)
+		// 回廊の外？
+		if (const ClusterGraph* corridor = context.GetCorridor())
 		{
-			for (uint32_t y = 0; y < mDepth; ++y)
-			{
-				for (uint32_t x = 0; x < mWidth; ++x)
-				{
-					const size_t index = Index(x, y, z);
-					Grid& grid = mGrids.get()[index];
-					if (!func(FIntVector(x, y, z), grid))
-						return;
-				}
-			}
+			if (!corridor->IsInCorridor(location))
+				return false;
 		}
+
+		// 侵入できる？
+		context.TrackRead(Index(location));
+		return TestEmptyBit(location);
 	}
 
-	void Voxel::Each(std::function<bool(const FIntVector& location, const Grid& grid)> func) const noexcept
+	bool Voxel::IsEmptyStairs(const FIntVector& location, const Direction direction, const int32_t altitude, SearchContext& context) const noexcept
 	{
-		for (uint32_t z = 0; z < mHeight; ++z)
+		const FIntVector forward = location + direction.GetVector();
+		const int32_t z = location.Z + altitude;
+		if (!Contain(forward) || z < 0 || static_cast<int32_t>(mHeight) <= z)
+			return false;
+
+		const FIntVector vertical(location.X, location.Y, z);
+		const FIntVector forwardVertical(forward.X, forward.Y, z);
+
+		// 回廊の外？
+		if (const ClusterGraph* corridor = context.GetCorridor())
 		{
-			for (uint32_t y = 0; y < mDepth; ++y)
-			{
-				for (uint32_t x = 0; x < mWidth; ++x)
-				{
-					const size_t index = Index(x, y, z);
-					Grid& grid = mGrids.get()[index];
-					if (!func(FIntVector(x, y, z), grid))
-						return;
-				}
-			}
+			if (!corridor->IsInCorridor(vertical) || !corridor->IsInCorridor(forward) || !corridor->IsInCorridor(forwardVertical))
+				return false;
 		}
+
+		context.TrackRead(Index(vertical));
+		context.TrackRead(Index(forward));
+		context.TrackRead(Index(forwardVertical));
+
+		// 上（下）の層の二グリッドは同じ層のビット列から続けて読む
+		const size_t verticalBit = EmptyBitIndex(vertical.X, vertical.Y, z);
+		const size_t forwardVerticalBit = EmptyBitIndex(forwardVertical.X, forwardVertical.Y, z);
+		const size_t forwardBit = EmptyBitIndex(forward.X, forward.Y, forward.Z);
+		return
+			(mEmptyBits[verticalBit >> 6] >> (verticalBit & 63)) &
+			(mEmptyBits[forwardVerticalBit >> 6] >> (forwardVerticalBit & 63)) &
+			(mEmptyBits[forwardBit >> 6] >> (forwardBit & 63)) & 1;
 	}
 
-	bool Voxel::IsEmpty(const FIntVector& location) const noexcept
+	void Voxel::RebuildEmptyBits() noexcept
 	{
-		// 範囲内？
-		if (!Contain(location))
-			return false;
-
-		// 侵入できる？
-		const size_t index = Index(location);
-		const auto& grid = mGrids.get()[index];
-		return grid.GetType() == Grid::Type::Empty;
+		std::fill(mEmptyBits.get(), mEmptyBits.get() + mEmptyBitsLayerWords * mHeight, 0);
+		mStorage.EachInStorageOrder([this](const uint32_t x, const uint32_t y, const uint32_t z, const Grid& grid)
+			{
+				UpdateEmptyBit(x, y, z, grid);
+				return true;
+			}
+		);
 	}
 #if 0
 	bool Voxel::IsHorizontallyPassable(const FIntVector& location) const noexcept
@@ -417,8 +757,7 @@ namespace dungeon
 			return false;
 
 		// 水平方向に侵入できる？
-		const size_t index = Index(location);
-		const auto& grid = mGrids.get()[index];
+		const auto& grid = mStorage.Get(location.X, location.Y, location.Z);
 
 		return grid.GetType() == Grid::Type::Empty || grid.GetType() == Grid::Type::Aisle;
 	}
@@ -430,8 +769,7 @@ namespace dungeon
 			return false;
 
 		// 水平方向に侵入できる？
-		const size_t index = Index(location);
-		const auto& grid = mGrids.get()[index];
+		const auto& grid = mStorage.Get(location.X, location.Y, location.Z);
 
 		if (grid.GetType() == Grid::Type::Deck && baseGrid.GetType() == Grid::Type::Deck)
 			return grid.GetIdentifier() != baseGrid.GetIdentifier();
@@ -459,4 +797,9 @@ namespace dungeon
 	{
 		return mHeight;
 	}
+
+	size_t Voxel::GetAllocatedSize() const noexcept
+	{
+		return mStorage.GetAllocatedSize();
+	}
 }
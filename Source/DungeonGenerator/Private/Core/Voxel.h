@@ -9,13 +9,15 @@ All Rights Reserved.
 #pragma once
 #include "Grid.h"
 #include "Identifier.h"
-#include <functional>
+#include "VoxelStorage.h"
 #include <memory>
+#include <vector>
 
 namespace dungeon
 {
 	// 前方宣言
 	class PathGoalCondition;
+	class SearchContext;
 	struct GenerateParameter;
 
 	/**
@@ -30,6 +32,19 @@ namespace dungeon
 			GoalPointIsOutsideGoalRange,
 		};
 
+		/**
+		グリッドに書き込む経路のノード
+		*/
+		struct RouteNode final
+		{
+			FIntVector mLocation;
+			Grid::Type mType;
+			Direction mDirection;
+		};
+
+		//! グリッドに書き込む経路
+		using Route = std::vector<RouteNode>;
+
 	public:
 		/**
 		コンストラクタ
@@ -56,6 +71,12 @@ namespace dungeon
 		*/
 		uint32_t GetHeight() const noexcept;
 
+		/**
+		グリッドの記憶領域の大きさを取得します
+		疎な記憶領域では確保したブリックの大きさだけを数えます
+		*/
+		size_t GetAllocatedSize() const noexcept;
+
 		/**
 		グリッド内のグリッドを取得します
 		\param[in]	x		X座標
@@ -64,7 +85,7 @@ namespace dungeon
 		TODO:座標関連はFIntVectorに統一して下さい
 		\return		グリッド
 		*/
-		const Grid& Get(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept;
+		Grid Get(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept;
 
 		/**
 		グリッド内のグリッドを設定します
@@ -101,45 +122,90 @@ namespace dungeon
 		\param[in]		goal		FIntVector
 		\param[in]		goalCondition	PathGoalCondition
 		\param[in]		identifier	Identifier
+		\param[in]		context		経路探索コンテキスト
 		\return			trueならば検索成功
 		*/
-		bool SearchGateLocation(FIntVector& result, const FIntVector& start, const FIntVector& goal, const PathGoalCondition& goalCondition, const Identifier& identifier) noexcept;
+		bool SearchGateLocation(FIntVector& result, const FIntVector& start, const FIntVector& goal, const PathGoalCondition& goalCondition, const Identifier& identifier, SearchContext& context) const noexcept;
 
 		/**
 		経路をGridに書き込みます
+		\param[out]	route			書き込んだ経路
 		\param[in]	start			始点
 		\param[in]	idealGoal		理想的な終点（goalCondition範囲内に含めて下さい）
 		\param[in]	goalCondition	終了条件
 		\param[in]	identifier		識別子
+		\param[in]	context			経路探索コンテキスト
 		\return		falseならば到達できなかった
 		*/
-		bool Aisle(const FIntVector& start, const FIntVector& idealGoal, const PathGoalCondition& goalCondition, const Identifier& identifier) noexcept;
+		bool Aisle(Route& route, const FIntVector& start, const FIntVector& idealGoal, const PathGoalCondition& goalCondition, const Identifier& identifier, SearchContext& context) noexcept;
 
 		/**
-		グリッド内のグリッドを更新します
-		\param[in]	func	グリッドを更新する関数
+		経路を探索します
+		グリッドは変更しないので、複数のスレッドから同時に呼び出せます
+		探索方法はcontextに設定された方法に従います
+		\param[out]	route			グリッドに書き込む経路
+		\param[in]	start			始点
+		\param[in]	idealGoal		理想的な終点（goalCondition範囲内に含めて下さい）
+		\param[in]	goalCondition	終了条件
+		\param[in]	context			経路探索コンテキスト
+		\return		falseならば到達できなかった
+		*/
+		bool FindAisle(Route& route, const FIntVector& start, const FIntVector& idealGoal, const PathGoalCondition& goalCondition, SearchContext& context) const noexcept;
+
+		/**
+		FindAisleで探索した経路をグリッドに書き込みます
+		\param[in]	route			経路
+		\param[in]	identifier		識別子
 		*/
-		void Each(std::function<bool(const FIntVector& location, Grid& grid)> func) noexcept;
+		void WriteAisle(const Route& route, const Identifier& identifier) noexcept;
 
 		/**
 		グリッド内のグリッドを更新します
-		\param[in]	func	グリッドを参照して更新する関数
+		呼び出し毎に空きグリッドのビットも更新します
+		\param[in]	func	bool(const FIntVector& location, Grid& grid)、falseを返すと中断します
 		*/
-		void Each(std::function<bool(const FIntVector& location, const Grid& grid)> func) const noexcept;
+		template<typename Function>
+		void Each(Function&& func) noexcept;
 
 		/**
-		グリッド内のグリッドを取得します
-		\param[in]	index	配列番号
-		\return		グリッド
+		グリッド内のグリッドを参照します
+		\param[in]	func	bool(const FIntVector& location, const Grid& grid)、falseを返すと中断します
+		*/
+		template<typename Function>
+		void Each(Function&& func) const noexcept;
+
+		/**
+		メモリに並んだ順番でグリッドを参照します
+		Tiled、Sparseでは座標の順番になりません。順番に依存しない読み取りに使って下さい
+		\param[in]	func	bool(const FIntVector& location, const Grid& grid)、falseを返すと中断します
+		*/
+		template<typename Function>
+		void EachInStorageOrder(Function&& func) const noexcept;
+
+		/**
+		Z座標毎に分けて複数のスレッドでグリッドを参照します
+		同じZ座標のグリッドは一つのスレッドがX、Yの順に参照しますが、Z座標の順番は決まりません。
+		関数は他のスレッドから同時に呼び出されるので、グリッドを書き換えずにZ座標毎に異なる領域へ書き込んで下さい。
+		\param[in]	func	void(const FIntVector& location, const Grid& grid)
 		*/
-		Grid& operator[](const size_t index) noexcept;
+		template<typename Function>
+		void ParallelEach(Function&& func) const;
+
+		/**
+		Y座標とZ座標が同じグリッドの並びを取得します
+		Linearのメモリ配置だけで取得できます
+		\param[in]	y		Y座標
+		\param[in]	z		Z座標
+		\return		幅の数のグリッドの先頭、Linear以外ではnullptr
+		*/
+		const Grid* GetRow(const uint32_t y, const uint32_t z) const noexcept;
 
 		/**
 		グリッド内のグリッドを取得します
 		\param[in]	index	配列番号
 		\return		グリッド
 		*/
-		const Grid& operator[](const size_t index) const noexcept;
+		Grid operator[](const size_t index) const noexcept;
 
 		/**
 		座標からボクセルのインデックスを取得します
@@ -173,9 +239,68 @@ namespace dungeon
 		/**
 		空きグリッドか調べます
 		\param[in]	location	座標
+		\param[in]	context		参照を記録する経路探索コンテキスト
 		\return		trueならば空いている
 		*/
-		bool IsEmpty(const FIntVector& location) const noexcept;
+		bool IsEmpty(const FIntVector& location, SearchContext& context) const noexcept;
+
+		/**
+		階段を置く三つのグリッドが空いているか調べます
+		\param[in]	location	階段の手前の座標
+		\param[in]	direction	階段の方向
+		\param[in]	altitude	上りなら1、下りなら-1
+		\param[in]	context		参照を記録する経路探索コンテキスト
+		\return		trueならば上（下）、前、前の上（下）のグリッドが全て空いている
+		*/
+		bool IsEmptyStairs(const FIntVector& location, const Direction direction, const int32_t altitude, SearchContext& context) const noexcept;
+
+		/**
+		空きグリッドのビット位置を取得します
+		\param[in]	x		X座標
+		\param[in]	y		Y座標
+		\param[in]	z		Z座標
+		\return		ビット位置
+		*/
+		size_t EmptyBitIndex(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept;
+
+		/**
+		空きグリッドのビットを更新します
+		\param[in]	x		X座標
+		\param[in]	y		Y座標
+		\param[in]	z		Z座標
+		\param[in]	grid	書き込んだグリッド
+		*/
+		void UpdateEmptyBit(const uint32_t x, const uint32_t y, const uint32_t z, const Grid& grid) noexcept;
+
+		/**
+		直方体の範囲の空きグリッドのビットをまとめて更新します
+		範囲はクランプ済みの最小座標と最大座標（含まない）を指定して下さい
+		\param[in]	min		最小座標
+		\param[in]	max		最大座標
+		\param[in]	grid	書き込んだグリッド
+		*/
+		void UpdateEmptyBits(const FIntVector& min, const FIntVector& max, const Grid& grid) noexcept;
+
+		/**
+		連続したビット列を同じ値で塗りつぶします
+		\param[in]	begin	先頭のビット位置
+		\param[in]	count	ビット数
+		\param[in]	empty	空いているか？
+		*/
+		void FillEmptyBitRun(const size_t begin, const size_t count, const bool empty) noexcept;
+
+		/**
+		空きグリッドのビットを調べます
+		座標は範囲内を指定して下さい
+		\param[in]	location	座標
+		\return		trueならば空いている
+		*/
+		bool TestEmptyBit(const FIntVector& location) const noexcept;
+
+		/**
+		全てのグリッドから空きグリッドのビット列を作り直します
+		*/
+		void RebuildEmptyBits() noexcept;
 
 		/**
 		水平方向の移動で進入できるか？
@@ -201,12 +326,34 @@ namespace dungeon
 		*/
 		static bool IsReachedGoal(const FIntVector& location, const int32_t goalAltitude, const PathGoalCondition& goalCondition) noexcept;
 
+		/**
+		始点から終点に向かって経路を探索します
+		引数はFindAisleと同じです
+		*/
+		bool FindAisleForward(Route& route, const FIntVector& start, const FIntVector& idealGoal, const PathGoalCondition& goalCondition, SearchContext& context) const noexcept;
+
+		/**
+		始点と終点の両側から経路を探索します
+		両側の探索が最初に出会ったノードで終了するので、経路は最短とは限らず長さの上限もありません。
+		両側の経路が重なる場合は失敗します
+		引数はFindAisleと同じです
+		*/
+		bool FindAisleBidirectionally(Route& route, const FIntVector& start, const FIntVector& idealGoal, const PathGoalCondition& goalCondition, SearchContext& context) const noexcept;
+
 	private:
-		std::unique_ptr<Grid[]> mGrids;
+		VoxelStorage mStorage;
 		uint32_t mWidth;
 		uint32_t mDepth;
 		uint32_t mHeight;
 
+		/*
+		空きグリッドのビット列
+		Z毎に64ビット境界から始まる層に詰めて、グリッドの種類を読まずに通行できるか調べます。
+		グリッドを書き換える関数は必ずこのビット列も更新して下さい。
+		*/
+		std::unique_ptr<uint64_t[]> mEmptyBits;
+		size_t mEmptyBitsLayerWords;
+
 		Error mLastError = Error::Success;
 	};
 }
@@ -7,6 +7,7 @@ All Rights Reserved.
 */
 
 #pragma once
+#include <Async/ParallelFor.h>
 
 namespace dungeon
 {
@@ -14,4 +15,110 @@ namespace dungeon
 	{
 		return mLastError;
 	}
+
+	template<typename Function>
+	inline void Voxel::Each(Function&& func) noexcept
+	{
+		for (uint32_t z = 0; z < mHeight; ++z)
+		{
+			for (uint32_t y = 0; y < mDepth; ++y)
+			{
+				for (uint32_t x = 0; x < mWidth; ++x)
+				{
+					bool result;
+					if (Grid* mutableGrid = mStorage.GetMutable(x, y, z))
+					{
+						result = func(FIntVector(x, y, z), *mutableGrid);
+						UpdateEmptyBit(x, y, z, *mutableGrid);
+					}
+					else
+					{
+						// 変更したグリッドだけを書き戻して、一様なブリックを確保しない
+						const Grid& current = mStorage.Get(x, y, z);
+						Grid grid = current;
+						result = func(FIntVector(x, y, z), grid);
+						if (grid != current)
+						{
+							mStorage.Set(x, y, z, grid);
+							UpdateEmptyBit(x, y, z, grid);
+						}
+					}
+					if (!result)
+						return;
+				}
+			}
+		}
+	}
+
+	template<typename Function>
+	inline void Voxel::Each(Function&& func) const noexcept
+	{
+		for (uint32_t z = 0; z < mHeight; ++z)
+		{
+			for (uint32_t y = 0; y < mDepth; ++y)
+			{
+				for (uint32_t x = 0; x < mWidth; ++x)
+				{
+					if (!func(FIntVector(x, y, z), mStorage.Get(x, y, z)))
+						return;
+				}
+			}
+		}
+	}
+
+	template<typename Function>
+	inline void Voxel::EachInStorageOrder(Function&& func) const noexcept
+	{
+		mStorage.EachInStorageOrder([&func](const uint32_t x, const uint32_t y, const uint32_t z, const Grid& grid)
+			{
+				return func(FIntVector(x, y, z), grid);
+			}
+		);
+	}
+
+	template<typename Function>
+	inline void Voxel::ParallelEach(Function&& func) const
+	{
+		const auto eachSlice = [this, &func](const uint32_t z)
+			{
+				for (uint32_t y = 0; y < mDepth; ++y)
+				{
+					for (uint32_t x = 0; x < mWidth; ++x)
+						func(FIntVector(x, y, z), mStorage.Get(x, y, z));
+				}
+			};
+
+		// Z座標毎にタスクグラフのワーカーに割り当てる
+		ParallelFor(static_cast<int32>(mHeight), [&eachSlice](const int32 z)
+			{
+				eachSlice(static_cast<uint32_t>(z));
+			}
+		);
+	}
+
+	inline const Grid* Voxel::GetRow(const uint32_t y, const uint32_t z) const noexcept
+	{
+		return mStorage.GetRow(y, z);
+	}
+
+	inline size_t Voxel::EmptyBitIndex(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept
+	{
+		return static_cast<size_t>(z) * mEmptyBitsLayerWords * 64 + static_cast<size_t>(y) * mWidth + x;
+	}
+
+	inline void Voxel::UpdateEmptyBit(const uint32_t x, const uint32_t y, const uint32_t z, const Grid& grid) noexcept
+	{
+		const size_t bit = EmptyBitIndex(x, y, z);
+		const uint64_t mask = static_cast<uint64_t>(1) << (bit & 63);
+		if (grid.GetType() == Grid::Type::Empty)
+			mEmptyBits[bit >> 6] |= mask;
+		else
+			mEmptyBits[bit >> 6] &= ~mask;
+	}
+
+	inline bool Voxel::TestEmptyBit(const FIntVector& location) const noexcept
+	{
+		const size_t bit = EmptyBitIndex(location.X, location.Y, location.Z);
+		return (mEmptyBits[bit >> 6] >> (bit & 63)) & 1;
+	}
 }
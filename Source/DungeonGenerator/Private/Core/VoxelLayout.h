@@ -0,0 +1,23 @@
+/**
+ボクセルのメモリ配置 ヘッダーファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+#include <cstdint>
+
+namespace dungeon
+{
+	/**
+	ボクセルのメモリ配置
+	*/
+	enum class VoxelLayout : uint8_t
+	{
+		Linear,		//!< X、Y、Zの順に並べた一つの配列
+		Tiled,		//!< 4x4x4のタイル毎に並べた一つの配列（前後上下の隣接グリッドが近くに並ぶ）
+		Sparse,		//!< 空白以外のグリッドがある8x8x8のブリックだけを確保する
+	};
+}
@@ -0,0 +1,149 @@
+/**
+ボクセルのグリッドの記憶領域 ソースファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#include "VoxelStorage.h"
+#include <algorithm>
+
+namespace dungeon
+{
+	VoxelStorage::VoxelStorage(const uint32_t width, const uint32_t depth, const uint32_t height, const VoxelLayout layout)
+		: mWidth(width)
+		, mDepth(depth)
+		, mHeight(height)
+		, mLayout(layout)
+	{
+		switch (layout)
+		{
+		case VoxelLayout::Linear:
+			mGrids = std::make_unique<Grid[]>(static_cast<size_t>(width) * depth * height);
+			break;
+
+		case VoxelLayout::Tiled:
+		{
+			mTileWidth = (width + TileMask) >> TileShift;
+			mTileDepth = (depth + TileMask) >> TileShift;
+			const uint32_t tileHeight = (height + TileMask) >> TileShift;
+			mTileCount = static_cast<size_t>(mTileWidth) * mTileDepth * tileHeight;
+			mGrids = std::make_unique<Grid[]>(mTileCount * TileCellCount);
+			break;
+		}
+
+		case VoxelLayout::Sparse:
+		{
+			mBrickWidth = (width + BrickMask) >> BrickShift;
+			mBrickDepth = (depth + BrickMask) >> BrickShift;
+			const uint32_t brickHeight = (height + BrickMask) >> BrickShift;
+			const size_t brickCount = static_cast<size_t>(mBrickWidth) * mBrickDepth * brickHeight;
+			mBricks.resize(brickCount);
+			mBrickFills.resize(brickCount);
+			break;
+		}
+		}
+	}
+
+	void VoxelStorage::Fill(const FIntVector& min, const FIntVector& max, const Grid& grid)
+	{
+		if (mLayout == VoxelLayout::Linear)
+		{
+			// 幅全体を覆う場合はZ座標毎に連続した一つの範囲になる
+			if (min.X == 0 && max.X == static_cast<int32_t>(mWidth))
+			{
+				for (int32_t z = min.Z; z < max.Z; ++z)
+				{
+					Grid* layer = mGrids.get() + LinearIndex(0, 0, z);
+					std::fill(layer + static_cast<size_t>(min.Y) * mWidth, layer + static_cast<size_t>(max.Y) * mWidth, grid);
+				}
+				return;
+			}
+
+			for (int32_t z = min.Z; z < max.Z; ++z)
+			{
+				for (int32_t y = min.Y; y < max.Y; ++y)
+				{
+					Grid* row = mGrids.get() + LinearIndex(0, y, z);
+					std::fill(row + min.X, row + max.X, grid);
+				}
+			}
+			return;
+		}
+
+		if (mLayout == VoxelLayout::Tiled)
+		{
+			for (int32_t z = min.Z; z < max.Z; ++z)
+			{
+				for (int32_t y = min.Y; y < max.Y; ++y)
+				{
+					for (int32_t x = min.X; x < max.X; ++x)
+						mGrids.get()[TiledIndex(x, y, z)] = grid;
+				}
+			}
+			return;
+		}
+
+		// ブリック毎に、範囲がブリック全体を覆うなら一様なブリックにする
+		for (int32_t bz = min.Z >> BrickShift; (bz << BrickShift) < max.Z; ++bz)
+		{
+			for (int32_t by = min.Y >> BrickShift; (by << BrickShift) < max.Y; ++by)
+			{
+				for (int32_t bx = min.X >> BrickShift; (bx << BrickShift) < max.X; ++bx)
+				{
+					const FIntVector brickMin(bx << BrickShift, by << BrickShift, bz << BrickShift);
+					const FIntVector brickMax(
+						std::min(brickMin.X + static_cast<int32_t>(BrickSize), static_cast<int32_t>(mWidth)),
+						std::min(brickMin.Y + static_cast<int32_t>(BrickSize), static_cast<int32_t>(mDepth)),
+						std::min(brickMin.Z + static_cast<int32_t>(BrickSize), static_cast<int32_t>(mHeight))
+					);
+					const FIntVector fillMin(std::max(min.X, brickMin.X), std::max(min.Y, brickMin.Y), std::max(min.Z, brickMin.Z));
+					const FIntVector fillMax(std::min(max.X, brickMax.X), std::min(max.Y, brickMax.Y), std::min(max.Z, brickMax.Z));
+
+					if (fillMin == brickMin && fillMax == brickMax)
+					{
+						const size_t brickIndex = BrickIndex(brickMin.X, brickMin.Y, brickMin.Z);
+						if (mBricks[brickIndex])
+						{
+							mBricks[brickIndex].reset();
+							--mAllocatedBrickCount;
+						}
+						mBrickFills[brickIndex] = grid;
+						continue;
+					}
+
+					for (int32_t z = fillMin.Z; z < fillMax.Z; ++z)
+					{
+						for (int32_t y = fillMin.Y; y < fillMax.Y; ++y)
+						{
+							for (int32_t x = fillMin.X; x < fillMax.X; ++x)
+								Set(x, y, z, grid);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	size_t VoxelStorage::GetAllocatedSize() const noexcept
+	{
+		if (mLayout == VoxelLayout::Linear)
+			return static_cast<size_t>(mWidth) * mDepth * mHeight * sizeof(Grid);
+		if (mLayout == VoxelLayout::Tiled)
+			return mTileCount * TileCellCount * sizeof(Grid);
+
+		return
+			mAllocatedBrickCount * BrickCellCount * sizeof(Grid) +
+			mBricks.size() * (sizeof(std::unique_ptr<Grid[]>) + sizeof(Grid));
+	}
+
+	Grid* VoxelStorage::Materialize(const size_t brickIndex)
+	{
+		std::unique_ptr<Grid[]>& brick = mBricks[brickIndex];
+		brick = std::make_unique<Grid[]>(BrickCellCount);
+		std::fill(brick.get(), brick.get() + BrickCellCount, mBrickFills[brickIndex]);
+		++mAllocatedBrickCount;
+		return brick.get();
+	}
+}
@@ -0,0 +1,171 @@
+/**
+ボクセルのグリッドの記憶領域 ヘッダーファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+#include "Grid.h"
+#include "VoxelLayout.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dungeon
+{
+	/**
+	ボクセルのグリッドの記憶領域クラス
+	Linearは全てのグリッドをX、Y、Zの順に一つの配列に確保します。
+	Tiledは全てのグリッドを4x4x4のタイル毎に一つの配列に確保し、
+	Y方向とZ方向の隣接グリッドを同じキャッシュラインの近くに置きます。
+	Sparseは8x8x8のブリックに分割し、全て同じグリッドのブリックは
+	共有した一つのグリッドで答え、異なるグリッドを書き込んだブリックだけを確保します。
+	*/
+	class VoxelStorage final
+	{
+	public:
+		/**
+		コンストラクタ
+		\param[in]	width	幅
+		\param[in]	depth	奥行き
+		\param[in]	height	高さ
+		\param[in]	layout	メモリ配置
+		*/
+		VoxelStorage(const uint32_t width, const uint32_t depth, const uint32_t height, const VoxelLayout layout);
+		VoxelStorage(const VoxelStorage&) = delete;
+		VoxelStorage& operator=(const VoxelStorage&) = delete;
+
+		/**
+		デストラクタ
+		*/
+		~VoxelStorage() = default;
+
+		/**
+		メモリ配置を取得します
+		*/
+		VoxelLayout GetLayout() const noexcept;
+
+		/**
+		グリッドを取得します
+		座標は範囲内を指定して下さい
+		\param[in]	x		X座標
+		\param[in]	y		Y座標
+		\param[in]	z		Z座標
+		\return		グリッド
+		Sparseでは書き換えでブリックの確保や解放が起きるので、参照ではなく値で返します
+		*/
+		Grid Get(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept;
+
+		/**
+		グリッドを取得します
+		\param[in]	index	z * width * depth + y * width + xのインデックス
+		\return		グリッド
+		*/
+		Grid Get(const size_t index) const noexcept;
+
+		/**
+		グリッドを設定します
+		ブリックと同じグリッドならばブリックを確保しません
+		座標は範囲内を指定して下さい
+		\param[in]	x		X座標
+		\param[in]	y		Y座標
+		\param[in]	z		Z座標
+		\param[in]	grid	グリッド
+		*/
+		void Set(const uint32_t x, const uint32_t y, const uint32_t z, const Grid& grid);
+
+		/**
+		直方体の範囲を同じグリッドで塗りつぶします
+		範囲がブリック全体を覆う場合はブリックを解放して共有したグリッドで答えます
+		範囲はクランプ済みの最小座標と最大座標（含まない）を指定して下さい
+		\param[in]	min		最小座標
+		\param[in]	max		最大座標
+		\param[in]	grid	グリッド
+		*/
+		void Fill(const FIntVector& min, const FIntVector& max, const Grid& grid);
+
+		/**
+		直方体の範囲のグリッドを関数で書き換えます
+		一様なブリック全体を覆う場合は共有したグリッドだけを書き換えます
+		関数の結果は引数のグリッドだけで決まるようにして下さい
+		範囲はクランプ済みの最小座標と最大座標（含まない）を指定して下さい
+		\param[in]	min			最小座標
+		\param[in]	max			最大座標
+		\param[in]	function	void(Grid& grid)
+		*/
+		template<typename Function>
+		void Transform(const FIntVector& min, const FIntVector& max, Function&& function);
+
+		/**
+		書き換え可能なグリッドを取得します
+		座標は範囲内を指定して下さい
+		\param[in]	x		X座標
+		\param[in]	y		Y座標
+		\param[in]	z		Z座標
+		\return		Sparseならばnullptr
+		*/
+		Grid* GetMutable(const uint32_t x, const uint32_t y, const uint32_t z) noexcept;
+
+		/**
+		Y座標とZ座標が同じグリッドの並びを取得します
+		\param[in]	y		Y座標
+		\param[in]	z		Z座標
+		\return		幅の数のグリッドの先頭、Linear以外ではnullptr
+		*/
+		const Grid* GetRow(const uint32_t y, const uint32_t z) const noexcept;
+
+		/**
+		メモリに並んだ順番でグリッドを参照します
+		順番はメモリ配置によって変わるので、順番に依存しない読み取りに使って下さい
+		\param[in]	function	bool(uint32_t x, uint32_t y, uint32_t z, const Grid& grid)、falseを返すと中断します
+		*/
+		template<typename Function>
+		void EachInStorageOrder(Function&& function) const;
+
+		/**
+		確保したグリッドの記憶領域の大きさを取得します
+		*/
+		size_t GetAllocatedSize() const noexcept;
+
+	private:
+		static constexpr uint32_t TileShift = 2;
+		static constexpr uint32_t TileSize = 1 << TileShift;
+		static constexpr uint32_t TileMask = TileSize - 1;
+		static constexpr size_t TileCellCount = TileSize * TileSize * TileSize;
+
+		static constexpr uint32_t BrickShift = 3;
+		static constexpr uint32_t BrickSize = 1 << BrickShift;
+		static constexpr uint32_t BrickMask = BrickSize - 1;
+		static constexpr size_t BrickCellCount = BrickSize * BrickSize * BrickSize;
+
+		size_t LinearIndex(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept;
+		size_t TiledIndex(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept;
+		size_t BrickIndex(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept;
+		static size_t CellIndex(const uint32_t x, const uint32_t y, const uint32_t z) noexcept;
+		Grid* Materialize(const size_t brickIndex);
+
+	private:
+		uint32_t mWidth;
+		uint32_t mDepth;
+		uint32_t mHeight;
+		VoxelLayout mLayout;
+
+		// LinearとTiledの記憶領域
+		std::unique_ptr<Grid[]> mGrids;
+		uint32_t mTileWidth = 0;
+		uint32_t mTileDepth = 0;
+		size_t mTileCount = 0;
+
+		// Sparseの記憶領域
+		uint32_t mBrickWidth = 0;
+		uint32_t mBrickDepth = 0;
+		std::vector<std::unique_ptr<Grid[]>> mBricks;
+		std::vector<Grid> mBrickFills;
+		size_t mAllocatedBrickCount = 0;
+	};
+}
+
+#include "VoxelStorage.inl"
@@ -0,0 +1,232 @@
+/**
+ボクセルのグリッドの記憶領域 インラインファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+#include <algorithm>
+
+namespace dungeon
+{
+	inline VoxelLayout VoxelStorage::GetLayout() const noexcept
+	{
+		return mLayout;
+	}
+
+	inline size_t VoxelStorage::LinearIndex(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept
+	{
+		return static_cast<size_t>(z) * mWidth * mDepth + static_cast<size_t>(y) * mWidth + x;
+	}
+
+	inline size_t VoxelStorage::TiledIndex(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept
+	{
+		const size_t tileIndex =
+			(static_cast<size_t>(z >> TileShift) * mTileDepth + (y >> TileShift)) * mTileWidth + (x >> TileShift);
+		const size_t cellIndex =
+			(static_cast<size_t>(z & TileMask) << (TileShift * 2)) |
+			(static_cast<size_t>(y & TileMask) << TileShift) |
+			static_cast<size_t>(x & TileMask);
+		return tileIndex * TileCellCount + cellIndex;
+	}
+
+	inline size_t VoxelStorage::BrickIndex(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept
+	{
+		return
+			(static_cast<size_t>(z >> BrickShift) * mBrickDepth + (y >> BrickShift)) * mBrickWidth + (x >> BrickShift);
+	}
+
+	inline size_t VoxelStorage::CellIndex(const uint32_t x, const uint32_t y, const uint32_t z) noexcept
+	{
+		return
+			(static_cast<size_t>(z & BrickMask) << (BrickShift * 2)) |
+			(static_cast<size_t>(y & BrickMask) << BrickShift) |
+			static_cast<size_t>(x & BrickMask);
+	}
+
+	inline Grid VoxelStorage::Get(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept
+	{
+		if (mLayout == VoxelLayout::Linear)
+			return mGrids.get()[LinearIndex(x, y, z)];
+		if (mLayout == VoxelLayout::Tiled)
+			return mGrids.get()[TiledIndex(x, y, z)];
+
+		const size_t brickIndex = BrickIndex(x, y, z);
+		const Grid* cells = mBricks[brickIndex].get();
+		return cells ? cells[CellIndex(x, y, z)] : mBrickFills[brickIndex];
+	}
+
+	inline Grid VoxelStorage::Get(const size_t index) const noexcept
+	{
+		if (mLayout == VoxelLayout::Linear)
+			return mGrids.get()[index];
+
+		const size_t layerSize = static_cast<size_t>(mWidth) * mDepth;
+		const uint32_t z = static_cast<uint32_t>(index / layerSize);
+		const size_t layerIndex = index - z * layerSize;
+		const uint32_t y = static_cast<uint32_t>(layerIndex / mWidth);
+		const uint32_t x = static_cast<uint32_t>(layerIndex - static_cast<size_t>(y) * mWidth);
+		return Get(x, y, z);
+	}
+
+	inline void VoxelStorage::Set(const uint32_t x, const uint32_t y, const uint32_t z, const Grid& grid)
+	{
+		if (Grid* cell = GetMutable(x, y, z))
+		{
+			*cell = grid;
+			return;
+		}
+
+		const size_t brickIndex = BrickIndex(x, y, z);
+		Grid* cells = mBricks[brickIndex].get();
+		if (cells == nullptr)
+		{
+			// 一様なブリックと同じグリッドならば確保しない
+			if (mBrickFills[brickIndex] == grid)
+				return;
+			cells = Materialize(brickIndex);
+		}
+		cells[CellIndex(x, y, z)] = grid;
+	}
+
+	inline Grid* VoxelStorage::GetMutable(const uint32_t x, const uint32_t y, const uint32_t z) noexcept
+	{
+		if (mLayout == VoxelLayout::Linear)
+			return &mGrids.get()[LinearIndex(x, y, z)];
+		if (mLayout == VoxelLayout::Tiled)
+			return &mGrids.get()[TiledIndex(x, y, z)];
+		return nullptr;
+	}
+
+	inline const Grid* VoxelStorage::GetRow(const uint32_t y, const uint32_t z) const noexcept
+	{
+		return mLayout == VoxelLayout::Linear ? &mGrids.get()[LinearIndex(0, y, z)] : nullptr;
+	}
+
+	template<typename Function>
+	inline void VoxelStorage::Transform(const FIntVector& min, const FIntVector& max, Function&& function)
+	{
+		if (mLayout == VoxelLayout::Linear)
+		{
+			for (int32_t z = min.Z; z < max.Z; ++z)
+			{
+				for (int32_t y = min.Y; y < max.Y; ++y)
+				{
+					Grid* row = mGrids.get() + LinearIndex(0, y, z);
+					for (int32_t x = min.X; x < max.X; ++x)
+						function(row[x]);
+				}
+			}
+			return;
+		}
+
+		if (mLayout == VoxelLayout::Tiled)
+		{
+			for (int32_t z = min.Z; z < max.Z; ++z)
+			{
+				for (int32_t y = min.Y; y < max.Y; ++y)
+				{
+					for (int32_t x = min.X; x < max.X; ++x)
+						function(mGrids.get()[TiledIndex(x, y, z)]);
+				}
+			}
+			return;
+		}
+
+		// ブリック毎に、確保していないブリックを覆うなら共有したグリッドだけを書き換える
+		for (int32_t bz = min.Z >> BrickShift; (bz << BrickShift) < max.Z; ++bz)
+		{
+			for (int32_t by = min.Y >> BrickShift; (by << BrickShift) < max.Y; ++by)
+			{
+				for (int32_t bx = min.X >> BrickShift; (bx << BrickShift) < max.X; ++bx)
+				{
+					const FIntVector brickMin(bx << BrickShift, by << BrickShift, bz << BrickShift);
+					const FIntVector brickMax(
+						std::min(brickMin.X + static_cast<int32_t>(BrickSize), static_cast<int32_t>(mWidth)),
+						std::min(brickMin.Y + static_cast<int32_t>(BrickSize), static_cast<int32_t>(mDepth)),
+						std::min(brickMin.Z + static_cast<int32_t>(BrickSize), static_cast<int32_t>(mHeight))
+					);
+					const FIntVector rangeMin(std::max(min.X, brickMin.X), std::max(min.Y, brickMin.Y), std::max(min.Z, brickMin.Z));
+					const FIntVector rangeMax(std::min(max.X, brickMax.X), std::min(max.Y, brickMax.Y), std::min(max.Z, brickMax.Z));
+
+					const size_t brickIndex = BrickIndex(brickMin.X, brickMin.Y, brickMin.Z);
+					Grid* cells = mBricks[brickIndex].get();
+					if (cells == nullptr)
+					{
+						if (rangeMin == brickMin && rangeMax == brickMax)
+						{
+							function(mBrickFills[brickIndex]);
+							continue;
+						}
+
+						// 書き換えても一様なままならば確保しない
+						Grid grid = mBrickFills[brickIndex];
+						function(grid);
+						if (grid == mBrickFills[brickIndex])
+							continue;
+						cells = Materialize(brickIndex);
+					}
+
+					for (int32_t z = rangeMin.Z; z < rangeMax.Z; ++z)
+					{
+						for (int32_t y = rangeMin.Y; y < rangeMax.Y; ++y)
+						{
+							for (int32_t x = rangeMin.X; x < rangeMax.X; ++x)
+								function(cells[CellIndex(x, y, z)]);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	template<typename Function>
+	inline void VoxelStorage::EachInStorageOrder(Function&& function) const
+	{
+		if (mLayout == VoxelLayout::Linear)
+		{
+			const Grid* grid = mGrids.get();
+			for (uint32_t z = 0; z < mHeight; ++z)
+			{
+				for (uint32_t y = 0; y < mDepth; ++y)
+				{
+					for (uint32_t x = 0; x < mWidth; ++x, ++grid)
+					{
+						if (!function(x, y, z, *grid))
+							return;
+					}
+				}
+			}
+			return;
+		}
+
+		// タイルまたはブリック毎に、範囲内のグリッドを並んだ順番に参照する
+		const uint32_t shift = mLayout == VoxelLayout::Tiled ? TileShift : BrickShift;
+		const uint32_t size = 1 << shift;
+		const uint32_t blockWidth = (mWidth + size - 1) >> shift;
+		const uint32_t blockDepth = (mDepth + size - 1) >> shift;
+		const uint32_t blockHeight = (mHeight + size - 1) >> shift;
+		for (uint32_t bz = 0; bz < blockHeight; ++bz)
+		{
+			for (uint32_t by = 0; by < blockDepth; ++by)
+			{
+				for (uint32_t bx = 0; bx < blockWidth; ++bx)
+				{
+					for (uint32_t z = bz << shift; z < std::min((bz + 1) << shift, mHeight); ++z)
+					{
+						for (uint32_t y = by << shift; y < std::min((by + 1) << shift, mDepth); ++y)
+						{
+							for (uint32_t x = bx << shift; x < std::min((bx + 1) << shift, mWidth); ++x)
+							{
+								if (!function(x, y, z, Get(x, y, z)))
+									return;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
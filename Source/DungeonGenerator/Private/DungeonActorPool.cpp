@@ -0,0 +1,168 @@
+/**
+生成したアクターを再利用するプール ソースファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#include "DungeonActorPool.h"
+#include "DungeonDoor.h"
+#include "DungeonRoomSensor.h"
+#include <Components/SceneComponent.h>
+#include <GameFramework/Actor.h>
+
+AActor* CDungeonActorPool::Acquire(UClass* actorClass, const FTransform& transform, const InitializeEvent& function)
+{
+	InactiveActors* inactiveActors = mInactiveActors.Find(actorClass);
+	if (inactiveActors == nullptr)
+		return nullptr;
+
+	// 同じ位置のアクターを優先し、無ければ他の位置のアクターを使います
+	// 外部で破棄されたアクターは飛ばします
+	AActor* actor = nullptr;
+	InactiveActor inactiveActor;
+	const FIntVector locationKey = ToLocationKey(transform.GetLocation());
+	while (actor == nullptr && inactiveActors->mActors.Num() > 0)
+	{
+		FIntVector key = locationKey;
+		if (!inactiveActors->mActors.Contains(key))
+			key = inactiveActors->mActors.CreateConstIterator().Key();
+
+		TArray<InactiveActor>& actors = inactiveActors->mActors.FindChecked(key);
+		inactiveActor = actors.Pop();
+		actor = inactiveActor.mActor.Get();
+		--inactiveActors->mNum;
+		if (actors.Num() <= 0)
+			inactiveActors->mActors.Remove(key);
+		if (!IsValid(actor))
+			actor = nullptr;
+	}
+	if (actor == nullptr)
+		return nullptr;
+
+	// 静的なルートコンポーネントは一時的に移動可能にして配置します
+	// 同じ位置に再利用するアクターは移動しません
+	USceneComponent* rootComponent = actor->GetRootComponent();
+	const bool moved = !actor->GetActorTransform().Equals(transform);
+	if (rootComponent && (moved || function))
+	{
+		const EComponentMobility::Type mobility = rootComponent->Mobility;
+		rootComponent->SetMobility(EComponentMobility::Movable);
+		if (moved)
+			actor->SetActorTransform(transform);
+		if (function)
+			function(actor);
+		rootComponent->SetMobility(mobility);
+	}
+	else
+	{
+		if (moved)
+			actor->SetActorTransform(transform);
+		if (function)
+			function(actor);
+	}
+
+	// 使っていない状態にする前の状態に戻します
+	actor->SetActorHiddenInGame(inactiveActor.mHidden);
+	actor->SetActorEnableCollision(inactiveActor.mCollisionEnabled);
+	actor->SetActorTickEnabled(inactiveActor.mTickEnabled);
+#if WITH_EDITOR
+	actor->SetIsTemporarilyHiddenInEditor(inactiveActor.mHiddenInEditor);
+#endif
+
+	mActiveActors.Add(actor);
+	return actor;
+}
+
+void CDungeonActorPool::AddActive(AActor* actor)
+{
+	if (IsValid(actor))
+		mActiveActors.Add(actor);
+}
+
+void CDungeonActorPool::AddInactive(AActor* actor)
+{
+	if (IsValid(actor))
+	{
+		InactiveActor inactiveActor = {
+			actor,
+			actor->IsHidden(),
+			actor->GetActorEnableCollision(),
+			actor->IsActorTickEnabled()
+		};
+
+		actor->SetActorHiddenInGame(true);
+		actor->SetActorEnableCollision(false);
+		actor->SetActorTickEnabled(false);
+#if WITH_EDITOR
+		// エディタのビューポートでも見えないようにする
+		inactiveActor.mHiddenInEditor = actor->IsTemporarilyHiddenInEditor();
+		actor->SetIsTemporarilyHiddenInEditor(true);
+#endif
+
+		InactiveActors& inactiveActors = mInactiveActors.FindOrAdd(actor->GetClass());
+		inactiveActors.mActors.FindOrAdd(ToLocationKey(actor->GetActorLocation())).Add(inactiveActor);
+		++inactiveActors.mNum;
+	}
+}
+
+void CDungeonActorPool::ReleaseAll()
+{
+	for (const TWeakObjectPtr<AActor>& weakActor : mActiveActors)
+	{
+		AActor* actor = weakActor.Get();
+		if (!IsValid(actor))
+			continue;
+
+		// 扉と部屋センサーは再利用の前に終了処理を呼びます
+		if (ADungeonDoor* dungeonDoor = Cast<ADungeonDoor>(actor))
+		{
+			dungeonDoor->Finalize();
+		}
+		else if (ADungeonRoomSensor* dungeonRoomSensor = Cast<ADungeonRoomSensor>(actor))
+		{
+			dungeonRoomSensor->Finalize();
+		}
+		AddInactive(actor);
+	}
+	mActiveActors.Reset();
+}
+
+void CDungeonActorPool::DestroyInactive(UClass* actorClass)
+{
+	InactiveActors inactiveActors;
+	if (!mInactiveActors.RemoveAndCopyValue(actorClass, inactiveActors))
+		return;
+
+	for (const auto& pair : inactiveActors.mActors)
+	{
+		for (const InactiveActor& inactiveActor : pair.Value)
+		{
+			AActor* actor = inactiveActor.mActor.Get();
+			if (IsValid(actor))
+				actor->Destroy();
+		}
+	}
+}
+
+void CDungeonActorPool::Reset()
+{
+	mInactiveActors.Reset();
+	mActiveActors.Reset();
+}
+
+int32 CDungeonActorPool::GetInactiveNum(UClass* actorClass) const
+{
+	const InactiveActors* inactiveActors = mInactiveActors.Find(actorClass);
+	return inactiveActors ? inactiveActors->mNum : 0;
+}
+
+FIntVector CDungeonActorPool::ToLocationKey(const FVector& location)
+{
+	return FIntVector(
+		FMath::RoundToInt(location.X),
+		FMath::RoundToInt(location.Y),
+		FMath::RoundToInt(location.Z)
+	);
+}
@@ -0,0 +1,117 @@
+/**
+生成したアクターを再利用するプール ヘッダーファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+#include <CoreMinimal.h>
+#include <functional>
+
+// Forward declaration
+class AActor;
+class UClass;
+
+/**
+生成したアクターをクラス毎に再利用するプール
+再生成の時にアクターを破棄せずに非表示にして残し、次の生成で位置を変えて再利用します。
+同じ位置に同じクラスのアクターを置く時はそのアクターを優先して、移動せずに再利用します。
+アクターはワールドが保持しているので、破棄されたアクターは弱参照で取り除きます。
+*/
+class CDungeonActorPool final
+{
+public:
+	/**
+	再利用するアクターの初期化関数
+	アクターのルートコンポーネントを移動可能にした状態で呼び出します
+	*/
+	using InitializeEvent = std::function<void(AActor*)>;
+
+public:
+	/**
+	コンストラクタ
+	*/
+	CDungeonActorPool() = default;
+	CDungeonActorPool(const CDungeonActorPool&) = delete;
+	CDungeonActorPool& operator=(const CDungeonActorPool&) = delete;
+
+	/**
+	デストラクタ
+	アクターは破棄しません
+	*/
+	~CDungeonActorPool() = default;
+
+	/**
+	使っていないアクターを取り出して配置します
+	\param[in]	actorClass	アクターのクラス
+	\param[in]	transform	ワールドトランスフォーム
+	\param[in]	function	再利用するアクターの初期化関数
+	\return		使っていないアクターが無ければnullptr
+	*/
+	AActor* Acquire(UClass* actorClass, const FTransform& transform, const InitializeEvent& function = nullptr);
+
+	/**
+	新しく生成したアクターを使用中として登録します
+	\param[in]	actor	アクター
+	*/
+	void AddActive(AActor* actor);
+
+	/**
+	新しく生成したアクターを使っていないアクターとして登録します
+	表示、コリジョンとティックの状態を記録して、再利用する時に戻します
+	\param[in]	actor	アクター
+	*/
+	void AddInactive(AActor* actor);
+
+	/**
+	使用中のアクターを全てプールに戻します
+	*/
+	void ReleaseAll();
+
+	/**
+	使っていないアクターを破棄します
+	\param[in]	actorClass	アクターのクラス
+	*/
+	void DestroyInactive(UClass* actorClass);
+
+	/**
+	登録したアクターを全て忘れます
+	アクターは破棄しません
+	*/
+	void Reset();
+
+	/**
+	使っていないアクターの数を取得します
+	\param[in]	actorClass	アクターのクラス
+	\return		使っていないアクターの数
+	*/
+	int32 GetInactiveNum(UClass* actorClass) const;
+
+private:
+	static FIntVector ToLocationKey(const FVector& location);
+
+	// 使っていないアクターと、使っていない状態にする前の状態
+	struct InactiveActor final
+	{
+		TWeakObjectPtr<AActor> mActor;
+		bool mHidden = false;
+		bool mCollisionEnabled = true;
+		bool mTickEnabled = false;
+#if WITH_EDITOR
+		bool mHiddenInEditor = false;
+#endif
+	};
+
+	// クラス毎の使っていないアクター（位置毎に分けて保持）
+	struct InactiveActors final
+	{
+		TMap<FIntVector, TArray<InactiveActor>> mActors;
+		int32 mNum = 0;
+	};
+
+private:
+	TMap<UClass*, InactiveActors> mInactiveActors;
+	TArray<TWeakObjectPtr<AActor>> mActiveActors;
+};
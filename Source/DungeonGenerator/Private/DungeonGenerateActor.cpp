@@ -7,6 +7,7 @@ All Rights Reserved.
 #include "DungeonGenerateActor.h"
 #include "DungeonGenerateParameter.h"
 #include "DungeonGeneratorCore.h"
+#include "DungeonMeshChunkBuilder.h"
 #include "DungeonMiniMapTextureLayer.h"
 #include "DungeonTransactionalHierarchicalInstancedStaticMeshComponent.h"
 #include "Core/Grid.h"
@@ -19,7 +20,9 @@ All Rights Reserved.
 
 //#include <EngineUtils.h>
 #include <Components/CapsuleComponent.h>
+#include <Components/StaticMeshComponent.h>
 #include <Engine/LevelStreaming.h>
+#include <Engine/StaticMeshActor.h>
 //#include <GameFramework/PlayerStart.h>
 #include <GameFramework/Character.h>
 #include <Kismet/GameplayStatics.h>
@@ -31,6 +34,45 @@ All Rights Reserved.
 #include <Kismet/KismetSystemLibrary.h>
 #endif
 
+namespace
+{
+	/**
+	インスタンスのトランスフォームを比較するためのキー
+	HISMに格納すると精度が落ちるので、行列の要素を量子化して比較します。
+	鏡映を含むトランスフォームも分解せずに比較できます。
+	*/
+	struct InstanceTransformKey final
+	{
+		int32 mElements[12];
+
+		explicit InstanceTransformKey(const FTransform& transform)
+		{
+			static constexpr double axisScale = 1000.0;
+			static constexpr double locationScale = 10.0;
+
+			const FMatrix matrix = transform.ToMatrixWithScale();
+			for (int32 row = 0; row < 4; ++row)
+			{
+				const double scale = row < 3 ? axisScale : locationScale;
+				for (int32 column = 0; column < 3; ++column)
+				{
+					mElements[row * 3 + column] = static_cast<int32>(FMath::RoundToDouble(static_cast<double>(matrix.M[row][column]) * scale));
+				}
+			}
+		}
+
+		bool operator==(const InstanceTransformKey& other) const
+		{
+			return FMemory::Memcmp(mElements, other.mElements, sizeof(mElements)) == 0;
+		}
+
+		friend uint32 GetTypeHash(const InstanceTransformKey& key)
+		{
+			return FCrc::MemCrc32(key.mElements, sizeof(key.mElements));
+		}
+	};
+}
+
 ADungeonGenerateActor::ADungeonGenerateActor(const FObjectInitializer& initializer)
 	: Super(initializer)
 	, BuildJobTag(TEXT(JENKINS_JOB_TAG))
@@ -50,60 +92,209 @@ ADungeonGenerateActor::ADungeonGenerateActor(const FObjectInitializer& initializ
 
 ADungeonGenerateActor::~ADungeonGenerateActor()
 {
-	DestroyImplementation();
+	// ガベージコレクション中にコンポーネントを破棄できないので、EndPlayとDestroyedで破棄します
 }
 
-void ADungeonGenerateActor::BeginAddInstance(TArray<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent*>& meshs)
+void ADungeonGenerateActor::BeginAddInstance(InstanceBatchMap& batches)
 {
-	for (auto mesh : meshs)
+	for (auto& pair : batches)
 	{
-		if (IsValid(mesh))
+		InstanceBatch& batch = pair.Value;
+		if (IsValid(batch.mComponent))
 		{
-			mesh->BeginTransaction(true);
+			batch.mComponent->BeginTransaction(true);
 		}
+		batch.mTransforms.Reset();
 	}
 }
 
-void ADungeonGenerateActor::AddInstance(TArray<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent*>& meshs, const UStaticMesh* staticMesh, const FTransform& transform)
+void ADungeonGenerateActor::AddInstance(TArray<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent*>& meshs, InstanceBatchMap& batches, UStaticMesh* staticMesh, const FTransform& transform)
 {
-	for (auto mesh : meshs)
+	if (!IsValid(staticMesh))
+		return;
+
+	const InstanceBatchKey key(staticMesh, ToInstanceSector(transform.GetLocation()));
+	InstanceBatch* batch = batches.Find(key);
+	if (batch == nullptr)
+	{
+		// 区画と階層毎に、最初のインスタンスでコンポーネントを作る
+		auto component = NewObject<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent>(this);
+		if (!IsValid(component))
+			return;
+
+		AddInstanceComponent(component);
+		component->RegisterComponent();
+		component->SetStaticMesh(staticMesh);
+		component->BeginTransaction(true);
+		meshs.Add(component);
+		batch = &batches.Add(key, { component, {} });
+	}
+	batch->mTransforms.Add(transform);
+}
+
+void ADungeonGenerateActor::EndAddInstance(TArray<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent*>& meshs, InstanceBatchMap& batches)
+{
+	TMap<InstanceTransformKey, int32> requiredTransforms;
+	TArray<int32> removeInstances;
+	TArray<FTransform> addTransforms;
+
+	for (auto iterator = batches.CreateIterator(); iterator; ++iterator)
 	{
-		if (IsValid(mesh))
+		InstanceBatch& batch = iterator.Value();
+		UDungeonTransactionalHierarchicalInstancedStaticMeshComponent* component = batch.mComponent;
+		if (!IsValid(component))
+		{
+			iterator.RemoveCurrent();
+			continue;
+		}
+
+		// 前回の生成から変化したインスタンスだけを削除と追加する
+		requiredTransforms.Reset();
+		for (const FTransform& transform : batch.mTransforms)
+		{
+			++requiredTransforms.FindOrAdd(InstanceTransformKey(transform));
+		}
+
+		removeInstances.Reset();
+		const int32 instanceCount = component->GetInstanceCount();
+		for (int32 i = 0; i < instanceCount; ++i)
+		{
+			FTransform transform;
+			component->GetInstanceTransform(i, transform, false);
+			int32* required = requiredTransforms.Find(InstanceTransformKey(transform));
+			if (required && *required > 0)
+				--(*required);
+			else
+				removeInstances.Add(i);
+		}
+
+		addTransforms.Reset();
+		for (const FTransform& transform : batch.mTransforms)
 		{
-			if (mesh->GetStaticMesh() == staticMesh)
+			int32* required = requiredTransforms.Find(InstanceTransformKey(transform));
+			if (required && *required > 0)
 			{
-				mesh->AddInstance(transform);
-				break;
+				--(*required);
+				addTransforms.Add(transform);
 			}
 		}
+
+		// 削除はインデックスが詰められる前に大きい方から行う
+		if (removeInstances.Num() > 0)
+		{
+#if UE_VERSION_NEWER_THAN(5, 0, 0)
+			component->RemoveInstances(removeInstances);
+#else
+			for (int32 i = removeInstances.Num() - 1; i >= 0; --i)
+			{
+				component->RemoveInstance(removeInstances[i]);
+			}
+#endif
+		}
+		if (addTransforms.Num() > 0)
+		{
+			component->AddInstances(addTransforms, false);
+		}
+		component->EndTransaction(true);
+
+		// インスタンスが無くなったコンポーネントは破棄する
+		if (component->GetInstanceCount() <= 0)
+		{
+			meshs.RemoveSwap(component);
+			component->DestroyComponent();
+			iterator.RemoveCurrent();
+			continue;
+		}
+
+		batch.mTransforms.Reset();
 	}
 }
 
-void ADungeonGenerateActor::EndAddInstance(TArray<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent*>& meshs)
+void ADungeonGenerateActor::DestroyInstances()
+{
+	mFloorBatches.Reset();
+	mSlopeBatches.Reset();
+	mWallBatches.Reset();
+	mRoomRoofBatches.Reset();
+	mAisleRoofBatches.Reset();
+	mPillarBatches.Reset();
+
+	DestroyComponents(FloorMeshs);
+	DestroyComponents(SlopeMeshs);
+	DestroyComponents(WallMeshs);
+	DestroyComponents(RoomRoofMeshs);
+	DestroyComponents(AisleRoofMeshs);
+	DestroyComponents(PillarMeshs);
+}
+
+FIntVector ADungeonGenerateActor::ToInstanceSector(const FVector& location) const
+{
+	const float sectorSize = DungeonGenerateParameter->GetGridSize() * static_cast<float>(FMath::Max(MeshChunkSize, 1));
+	return FIntVector(
+		FMath::FloorToInt(location.X / sectorSize),
+		FMath::FloorToInt(location.Y / sectorSize),
+		FindFloorHeight(location.Z)
+	);
+}
+
+void ADungeonGenerateActor::AddTerrainMesh(TArray<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent*>& meshs, InstanceBatchMap& batches, UStaticMesh* staticMesh, const FTransform& transform)
+{
+	// 結合できないメッシュはインスタンスとして追加する
+	if (mMeshChunkBuilder && mMeshChunkBuilder->Add(staticMesh, transform))
+		return;
+
+	AddInstance(meshs, batches, staticMesh, transform);
+}
+
+void ADungeonGenerateActor::BuildMeshChunks()
+{
+	if (mMeshChunkBuilder == nullptr)
+		return;
+
+	mMeshChunkBuilder->Build(this, [this](UStaticMesh* staticMesh, const FVector& origin)
+		{
+			auto component = NewObject<UStaticMeshComponent>(this);
+			if (IsValid(component))
+			{
+				component->SetWorldLocation(origin);
+				AddInstanceComponent(component);
+				component->RegisterComponent();
+				component->SetStaticMesh(staticMesh);
+				ChunkMeshs.Add(component);
+			}
+		}
+	);
+	mMeshChunkBuilder.reset();
+}
+
+template<typename T>
+void ADungeonGenerateActor::DestroyComponents(TArray<T*>& components)
 {
-	for (auto mesh : meshs)
+	for (T* component : components)
 	{
-		if (IsValid(mesh))
+		if (IsValid(component))
 		{
-			mesh->EndTransaction(true);
+			component->DestroyComponent();
 		}
 	}
+	components.Empty();
 }
 
 /**
 2D空間は（X軸:前 Y軸:右）
 3D空間は（X軸:前 Y軸:右 Z軸:上）である事に注意
 */
-FBox ADungeonGenerateActor::ToWorldBoundingBox(const std::shared_ptr<const dungeon::Room>& room, const float gridSize)
+FBox ADungeonGenerateActor::ToWorldBoundingBox(const dungeon::Room& room, const float gridSize)
 {
-	const FVector min = FVector(room->GetLeft(), room->GetTop(), room->GetBackground()) * gridSize;
-	const FVector max = FVector(room->GetRight(), room->GetBottom(), room->GetForeground()) * gridSize;
+	const FVector min = FVector(room.GetLeft(), room.GetTop(), room.GetBackground()) * gridSize;
+	const FVector max = FVector(room.GetRight(), room.GetBottom(), room.GetForeground()) * gridSize;
 	return FBox(min, max);
 }
 
 void ADungeonGenerateActor::PreGenerateImplementation()
 {
-	DestroyImplementation();
+	// 生成したアクターを再利用するためにコアは破棄せずに残します
+	ReleaseImplementation();
 
 	if (!IsValid(DungeonGenerateParameter))
 	{
@@ -111,131 +302,76 @@ void ADungeonGenerateActor::PreGenerateImplementation()
 		return;
 	}
 
-	mDungeonGeneratorCore = std::make_shared<CDungeonGeneratorCore>(GetWorld());
 	if (mDungeonGeneratorCore == nullptr)
 	{
-		DUNGEON_GENERATOR_ERROR(TEXT("Failed to generate the DungeonGeneratorCore class"));
-		return;
+		mDungeonGeneratorCore = std::make_shared<CDungeonGeneratorCore>(GetWorld());
+		if (mDungeonGeneratorCore == nullptr)
+		{
+			DUNGEON_GENERATOR_ERROR(TEXT("Failed to generate the DungeonGeneratorCore class"));
+			return;
+		}
+	}
+	else
+	{
+		mDungeonGeneratorCore->ResetTerrainEvents();
 	}
 
+#if WITH_EDITORONLY_DATA && (UE_BUILD_SHIPPING == 0)
+	// ヒートマップは表示する時だけ記録します
+	mDungeonGeneratorCore->EnableAisleSearchHeatmap(ShowAisleSearchHeatmap);
+#endif
+
 	if (InstancedStaticMesh)
 	{
-		DestroyImplementation();
+		// 地形をアクターで生成した時のメッシュアクターは再利用されないので破棄します
+		mDungeonGeneratorCore->DestroyInactiveActors(AStaticMeshActor::StaticClass());
 
-		DungeonGenerateParameter->EachFloorParts([this](const FDungeonMeshParts& meshParts)
-			{
-				auto component = NewObject<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent>(this);
-				if (IsValid(component))
-				{
-					AddInstanceComponent(component);
-					component->RegisterComponent();
-					component->SetStaticMesh(meshParts.StaticMesh);
-				}
-				FloorMeshs.Add(component);
-			}
-		);
-		DungeonGenerateParameter->EachSlopeParts([this](const FDungeonMeshParts& meshParts)
-			{
-				auto component = NewObject<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent>(this);
-				if (IsValid(component))
-				{
-					AddInstanceComponent(component);
-					component->RegisterComponent();
-					component->SetStaticMesh(meshParts.StaticMesh);
-				}
-				SlopeMeshs.Add(component);
-			}
-		);
-		DungeonGenerateParameter->EachWallParts([this](const FDungeonMeshParts& meshParts)
-			{
-				auto component = NewObject<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent>(this);
-				if (IsValid(component))
-				{
-					AddInstanceComponent(component);
-					component->RegisterComponent();
-					component->SetStaticMesh(meshParts.StaticMesh);
-				}
-				WallMeshs.Add(component);
-			}
-		);
-		DungeonGenerateParameter->EachRoomRoofParts([this](const FDungeonMeshParts& meshParts)
-			{
-				auto component = NewObject<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent>(this);
-				if (IsValid(component))
-				{
-					AddInstanceComponent(component);
-					component->RegisterComponent();
-					component->SetStaticMesh(meshParts.StaticMesh);
-				}
-				RoomRoofMeshs.Add(component);
-			}
-		);
-		DungeonGenerateParameter->EachAisleRoofParts([this](const FDungeonMeshParts& meshParts)
-			{
-				auto component = NewObject<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent>(this);
-				if (IsValid(component))
-				{
-					AddInstanceComponent(component);
-					component->RegisterComponent();
-					component->SetStaticMesh(meshParts.StaticMesh);
-				}
-				AisleRoofMeshs.Add(component);
-			}
-		);
-		DungeonGenerateParameter->EachPillarParts([this](const FDungeonMeshParts& meshParts)
-			{
-				auto component = NewObject<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent>(this);
-				if (IsValid(component))
-				{
-					AddInstanceComponent(component);
-					component->RegisterComponent();
-					component->SetStaticMesh(meshParts.StaticMesh);
-				}
-				PillarMeshs.Add(component);
-			}
-		);
+		if (MergeMeshChunks)
+			mMeshChunkBuilder = std::make_shared<CDungeonMeshChunkBuilder>(DungeonGenerateParameter->GetGridSize(), MeshChunkSize);
 
-		BeginAddInstance(FloorMeshs);
-		BeginAddInstance(SlopeMeshs);
-		BeginAddInstance(WallMeshs);
-		BeginAddInstance(RoomRoofMeshs);
-		BeginAddInstance(AisleRoofMeshs);
-		BeginAddInstance(PillarMeshs);
+		// コンポーネントは区画と階層毎に最初のインスタンスを追加する時に作ります
+		BeginAddInstance(mFloorBatches);
+		BeginAddInstance(mSlopeBatches);
+		BeginAddInstance(mWallBatches);
+		BeginAddInstance(mRoomRoofBatches);
+		BeginAddInstance(mAisleRoofBatches);
+		BeginAddInstance(mPillarBatches);
 
 		// Add
 		mDungeonGeneratorCore->OnAddFloor([this](UStaticMesh* staticMesh, const FTransform& transform)
 			{
-				AddInstance(FloorMeshs, staticMesh, transform);
+				AddTerrainMesh(FloorMeshs, mFloorBatches, staticMesh, transform);
 				OnCreateFloor.Broadcast(transform);
 			}
 		);
 		mDungeonGeneratorCore->OnAddSlope([this](UStaticMesh* staticMesh, const FTransform& transform)
 			{
-				AddInstance(SlopeMeshs, staticMesh, transform);
+				// ボックスのコリジョンでは登れなくなるので、斜面は結合せずに元のコリジョンを使う
+				AddInstance(SlopeMeshs, mSlopeBatches, staticMesh, transform);
 				OnCreateSlope.Broadcast(transform);
 			}
 		);
 		mDungeonGeneratorCore->OnAddWall([this](UStaticMesh* staticMesh, const FTransform& transform)
 			{
-				AddInstance(WallMeshs, staticMesh, transform);
+				AddTerrainMesh(WallMeshs, mWallBatches, staticMesh, transform);
 				OnCreateWall.Broadcast(transform);
 			}
 		);
 		mDungeonGeneratorCore->OnAddRoomRoof([this](UStaticMesh* staticMesh, const FTransform& transform)
 			{
-				AddInstance(RoomRoofMeshs, staticMesh, transform);
+				AddTerrainMesh(RoomRoofMeshs, mRoomRoofBatches, staticMesh, transform);
 				OnCreateAisleRoof.Broadcast(transform);
 			}
 		);
 		mDungeonGeneratorCore->OnAddAisleRoof([this](UStaticMesh* staticMesh, const FTransform& transform)
 			{
-				AddInstance(AisleRoofMeshs, staticMesh, transform);
+				AddTerrainMesh(AisleRoofMeshs, mAisleRoofBatches, staticMesh, transform);
 				OnCreateAisleRoof.Broadcast(transform);
 			}
 		);
 		mDungeonGeneratorCore->OnAddPillar([this](uint32_t gridHeight, UStaticMesh* staticMesh, const FTransform& transform)
 			{
-				AddInstance(PillarMeshs, staticMesh, transform);
+				AddTerrainMesh(PillarMeshs, mPillarBatches, staticMesh, transform);
 				OnCreatePillar.Broadcast(transform);
 			}
 		);
@@ -249,12 +385,13 @@ void ADungeonGenerateActor::PreGenerateImplementation()
 
 		if (mDungeonGeneratorCore->Create(DungeonGenerateParameter))
 		{
-			EndAddInstance(FloorMeshs);
-			EndAddInstance(SlopeMeshs);
-			EndAddInstance(WallMeshs);
-			EndAddInstance(RoomRoofMeshs);
-			EndAddInstance(AisleRoofMeshs);
-			EndAddInstance(PillarMeshs);
+			EndAddInstance(FloorMeshs, mFloorBatches);
+			EndAddInstance(SlopeMeshs, mSlopeBatches);
+			EndAddInstance(WallMeshs, mWallBatches);
+			EndAddInstance(RoomRoofMeshs, mRoomRoofBatches);
+			EndAddInstance(AisleRoofMeshs, mAisleRoofBatches);
+			EndAddInstance(PillarMeshs, mPillarBatches);
+			BuildMeshChunks();
 			MovePlayerStart();
 		}
 		else
@@ -265,6 +402,8 @@ void ADungeonGenerateActor::PreGenerateImplementation()
 	}
 	else
 	{
+		DestroyInstances();
+
 		if (mDungeonGeneratorCore->Create(DungeonGenerateParameter))
 		{
 			MovePlayerStart();
@@ -296,10 +435,10 @@ void ADungeonGenerateActor::PostGenerateImplementation()
 			UNavigationSystemV1* navigationSystem = UNavigationSystemV1::GetCurrent(GetWorld());
 			const float gridSize = DungeonGenerateParameter->GetGridSize();
 
-			generator->ForEach([this, gridSize, navigationSystem](const std::shared_ptr<const dungeon::Room>& room)
+			generator->ForEach([this, gridSize, navigationSystem](const dungeon::Room& room)
 				{
 					const FBox box = ToWorldBoundingBox(room, gridSize);
-					OnRoomCreated.Broadcast(false, static_cast<EDungeonRoomParts>(room->GetParts()), box);
+					OnRoomCreated.Broadcast(false, static_cast<EDungeonRoomParts>(room.GetParts()), box);
 
 					if (navigationSystem)
 					{
@@ -316,6 +455,22 @@ void ADungeonGenerateActor::PostGenerateImplementation()
 	}
 }
 
+void ADungeonGenerateActor::ReleaseImplementation()
+{
+	// 生成したアクターは破棄せずにプールに戻します
+	if (mDungeonGeneratorCore != nullptr)
+	{
+		mDungeonGeneratorCore->ReleaseSpawnedActors();
+		mDungeonGeneratorCore->UnloadStreamLevels();
+	}
+
+	// インスタンスは次の生成で差分だけを更新するので残します
+	mMeshChunkBuilder.reset();
+	DestroyComponents(ChunkMeshs);
+
+	DungeonMiniMapTextureLayer = nullptr;
+}
+
 void ADungeonGenerateActor::DestroyImplementation()
 {
 	if (mDungeonGeneratorCore != nullptr)
@@ -325,14 +480,8 @@ void ADungeonGenerateActor::DestroyImplementation()
 		mDungeonGeneratorCore.reset();
 	}
 
-	FloorMeshs.Empty();
-	SlopeMeshs.Empty();
-	WallMeshs.Empty();
-	RoomRoofMeshs.Empty();
-	AisleRoofMeshs.Empty();
-	PillarMeshs.Empty();
-
-	DungeonMiniMapTextureLayer = nullptr;
+	ReleaseImplementation();
+	DestroyInstances();
 }
 
 /*
@@ -402,6 +551,15 @@ void ADungeonGenerateActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	Super::EndPlay(EndPlayReason);
 }
 
+void ADungeonGenerateActor::Destroyed()
+{
+	// エディタで削除された場合はEndPlayが呼ばれないので、ここで破棄します
+	DestroyImplementation();
+
+	// 親クラスの呼び出し
+	Super::Destroyed();
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // BluePrint Useful Functions
 void ADungeonGenerateActor::GenerateDungeon()
@@ -415,6 +573,25 @@ void ADungeonGenerateActor::DestroyDungeon()
 	DestroyImplementation();
 }
 
+void ADungeonGenerateActor::PrewarmActors(TSubclassOf<AActor> actorClass, const int32 count)
+{
+	if (actorClass == nullptr || count <= 0)
+		return;
+
+	// ロード中に呼び出せるように生成前でもコアを作ります
+	if (mDungeonGeneratorCore == nullptr)
+	{
+		mDungeonGeneratorCore = std::make_shared<CDungeonGeneratorCore>(GetWorld());
+		if (mDungeonGeneratorCore == nullptr)
+		{
+			DUNGEON_GENERATOR_ERROR(TEXT("Failed to generate the DungeonGeneratorCore class"));
+			return;
+		}
+	}
+
+	mDungeonGeneratorCore->PrewarmActors(actorClass, TEXT("Dungeon/Actors"), count);
+}
+
 int32 ADungeonGenerateActor::FindFloorHeight(const float z) const
 {
 	if (mDungeonGeneratorCore == nullptr)
@@ -422,6 +599,8 @@ int32 ADungeonGenerateActor::FindFloorHeight(const float z) const
 
 	const int32 gridZ = FindVoxelHeight(z);
 	const std::shared_ptr<const dungeon::Generator>& generator = mDungeonGeneratorCore->GetGenerator();
+	if (generator == nullptr)
+		return 0;
 	return generator->FindFloor(gridZ);
 }
 
@@ -505,12 +684,12 @@ void ADungeonGenerateActor::DrawDebugInformation()
 	// 部屋と接続情報のデバッグ情報を表示します
 	if (ShowRoomAisleInformation)
 	{
-		generator->ForEach([this, gridSize](const std::shared_ptr<const dungeon::Room>& room)
+		generator->ForEach([this, gridSize](const dungeon::Room& room)
 			{
 				UKismetSystemLibrary::DrawDebugBox(
 					GetWorld(),
-					room->GetCenter() * gridSize,
-					room->GetExtent() * gridSize,
+					room.GetCenter() * gridSize,
+					room.GetExtent() * gridSize,
 					FColor::Magenta,
 					FRotator::ZeroRotator,
 					0.f,
@@ -519,7 +698,7 @@ void ADungeonGenerateActor::DrawDebugInformation()
 
 				UKismetSystemLibrary::DrawDebugSphere(
 					GetWorld(),
-					room->GetGroundCenter() * gridSize,
+					room.GetGroundCenter() * gridSize,
 					10.f,
 					12,
 					FColor::Magenta,
@@ -616,6 +795,11 @@ void ADungeonGenerateActor::DrawDebugInformation()
 		);
 	}
 
+#if WITH_EDITOR
+	// 通路の探索でボクセルグリッドを展開した回数を表示します
+	mDungeonGeneratorCore->DrawDebugInformation(false, false, ShowAisleSearchHeatmap);
+#endif
+
 #if 0
 	// ダンジョン全体の領域を可視化
 	{
@@ -5,6 +5,7 @@ All Rights Reserved.
 */
 
 #include "DungeonGeneratorCore.h"
+#include "DungeonActorPool.h"
 #include "DungeonGenerateParameter.h"
 #include "DungeonDoor.h"
 #include "DungeonLevelStreamingDynamic.h"
@@ -12,8 +13,11 @@ All Rights Reserved.
 #include "DungeonRoomSensor.h"
 #include "Core/Debug/Debug.h"
 #include "Core/Debug/BuildInfomation.h"
+#include "Core/Debug/Stopwatch.h"
+#include "Core/FeatureMask.h"
 #include "Core/Identifier.h"
 #include "Core/Generator.h"
+#include "Core/RouteCache.h"
 #include "Core/Voxel.h"
 #include "Core/Math/Math.h"
 #include <TextureResource.h>
@@ -29,6 +33,11 @@ All Rights Reserved.
 #include <Components/BrushComponent.h>
 #include <Engine/Polys.h>
 
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <vector>
+
 #if WITH_EDITOR
 // UnrealEd
 #include <EditorLevelUtils.h>
@@ -46,6 +55,115 @@ namespace
 	{
 		return FTransform(FRotator(0.f, yaw, 0.f).Quaternion(), position);
 	}
+
+	/*
+	地形のメッシュの種類
+	*/
+	enum class TerrainCategory : uint8_t
+	{
+		Floor,
+		Slope,
+		Wall,
+		RoomRoof,
+		AisleRoof,
+		Pillar,
+		Size
+	};
+	constexpr size_t TerrainCategorySize = static_cast<size_t>(TerrainCategory::Size);
+
+	/*
+	部品の選択に使う乱数の用途
+	グリッドのインデックスと組み合わせて、グリッド毎に独立した乱数を作ります
+	*/
+	enum class TerrainRandomStream : uint32_t
+	{
+		Floor,
+		Slope,
+		Wall,
+		RoomRoof,
+		AisleRoof,
+		Pillar,
+		Torch,
+		Door
+	};
+
+	/*
+	同じ種類と同じメッシュの配置をまとめたバッファ
+	*/
+	struct TerrainMeshBuffer final
+	{
+		UStaticMesh* mStaticMesh;
+		std::vector<FTransform> mTransforms;
+		std::vector<uint32_t> mPillarHeights;
+	};
+
+	/*
+	地形と一緒に配置するアクター
+	*/
+	struct TerrainActorPlacement final
+	{
+		UClass* mActorClass;
+		FTransform mTransform;
+		EDungeonRoomProps mProps;
+		bool mDoor;
+	};
+
+	/*
+	Z座標毎の地形の分類結果
+	一つのZ座標は一つのスレッドだけが書き込みます
+	*/
+	struct TerrainSlice final
+	{
+		std::array<std::vector<TerrainMeshBuffer>, TerrainCategorySize> mMeshes;
+		std::vector<TerrainActorPlacement> mActors;
+
+		void AddMesh(const TerrainCategory category, UStaticMesh* staticMesh, const FTransform& transform, const uint32_t pillarHeight = 0)
+		{
+			std::vector<TerrainMeshBuffer>& buffers = mMeshes[static_cast<size_t>(category)];
+			auto buffer = std::find_if(buffers.begin(), buffers.end(), [staticMesh](const TerrainMeshBuffer& buffer)
+				{
+					return buffer.mStaticMesh == staticMesh;
+				}
+			);
+			if (buffer == buffers.end())
+			{
+				buffers.push_back({ staticMesh, {}, {} });
+				buffer = std::prev(buffers.end());
+			}
+			buffer->mTransforms.push_back(transform);
+			if (category == TerrainCategory::Pillar)
+				buffer->mPillarHeights.push_back(pillarHeight);
+		}
+	};
+
+	/*
+	Z座標毎の分類結果をメッシュ毎のバッファにまとめます
+	*/
+	std::vector<TerrainMeshBuffer> MergeTerrainSlices(std::vector<TerrainSlice>& slices, const TerrainCategory category)
+	{
+		std::vector<TerrainMeshBuffer> merged;
+		for (TerrainSlice& slice : slices)
+		{
+			for (TerrainMeshBuffer& buffer : slice.mMeshes[static_cast<size_t>(category)])
+			{
+				auto destination = std::find_if(merged.begin(), merged.end(), [&buffer](const TerrainMeshBuffer& mergedBuffer)
+					{
+						return mergedBuffer.mStaticMesh == buffer.mStaticMesh;
+					}
+				);
+				if (destination == merged.end())
+				{
+					merged.push_back(std::move(buffer));
+				}
+				else
+				{
+					destination->mTransforms.insert(destination->mTransforms.end(), buffer.mTransforms.begin(), buffer.mTransforms.end());
+					destination->mPillarHeights.insert(destination->mPillarHeights.end(), buffer.mPillarHeights.begin(), buffer.mPillarHeights.end());
+				}
+			}
+		}
+		return merged;
+	}
 }
 
 const FName& CDungeonGeneratorCore::GetDungeonGeneratorTag()
@@ -55,6 +173,12 @@ const FName& CDungeonGeneratorCore::GetDungeonGeneratorTag()
 
 CDungeonGeneratorCore::CDungeonGeneratorCore(const TWeakObjectPtr<UWorld>& world)
 	: mWorld(world)
+	, mActorPool(std::make_shared<CDungeonActorPool>())
+{
+	ResetTerrainEvents();
+}
+
+void CDungeonGeneratorCore::ResetTerrainEvents()
 {
 	AddStaticMeshEvent addStaticMeshEvent = [this](UStaticMesh* staticMesh, const FTransform& transform)
 	{
@@ -98,9 +222,22 @@ bool CDungeonGeneratorCore::Create(const UDungeonGenerateParameter* parameter)
 	generateParameter.mMaxRoomHeight = parameter->RoomHeight.Max;
 	generateParameter.mHorizontalRoomMargin = parameter->RoomMargin;
 	generateParameter.mVerticalRoomMargin = parameter->VerticalRoomMargin;
+	generateParameter.mParallelAisleRouting = parameter->ParallelAisleRouting;
+	generateParameter.mHierarchicalAisleRouting = parameter->HierarchicalAisleRouting;
+	generateParameter.mCacheGateCandidates = parameter->CacheGateCandidates;
+	generateParameter.mAisleSearchMode = static_cast<dungeon::AisleSearchMode>(parameter->AisleSearchMode);
+	generateParameter.mAisleHeuristicsWeight = parameter->AisleHeuristicsWeight;
+	generateParameter.mVoxelLayout = static_cast<dungeon::VoxelLayout>(parameter->VoxelLayout);
+	generateParameter.mAisleSearchHeatmap = mAisleSearchHeatmap;
 	mParameter = parameter;
 
+	// 再生成で変わらない通路は記録した経路を再生する
+	if (!mRouteCache)
+		mRouteCache = std::make_shared<dungeon::RouteCache>();
+
+	mFeatureMask.reset();
 	mGenerator = std::make_shared<dungeon::Generator>();
+	mGenerator->SetRouteCache(mRouteCache);
 	mGenerator->OnQueryParts([this, parameter](const std::shared_ptr<dungeon::Room>& room)
 	{
 		CreateImpl_AddRoomAsset(parameter, room);
@@ -135,8 +272,14 @@ bool CDungeonGeneratorCore::Create(const UDungeonGenerateParameter* parameter)
 	}
 	else
 	{
+		// メモリ配置毎の比較のためにメッシュの配置にかかった時間を出力する
+		Stopwatch stopwatch;
+		mFeatureMask = std::make_shared<dungeon::FeatureMask>(*mGenerator->GetVoxel(), parameter->MergeRooms);
+		DUNGEON_GENERATOR_LOG(TEXT("FeatureMask: %lf sec"), stopwatch.Lap());
 		AddTerrain();
+		DUNGEON_GENERATOR_LOG(TEXT("AddTerrain: %lf sec"), stopwatch.Lap());
 		AddObject();
+		DUNGEON_GENERATOR_LOG(TEXT("AddObject: %lf sec"), stopwatch.Lap());
 
 		DUNGEON_GENERATOR_LOG(TEXT("Done."));
 		return true;
@@ -226,35 +369,56 @@ void CDungeonGeneratorCore::AddTerrain()
 		return;
 	}
 
-	mGenerator->GetVoxel()->Each([this, parameter](const FIntVector& location, const dungeon::Grid& grid)
+	check(mFeatureMask);
+	const dungeon::FeatureMask& featureMask = *mFeatureMask;
+	const std::shared_ptr<dungeon::Voxel>& voxel = mGenerator->GetVoxel();
+
+	/*
+	Z座標毎に並列に分類して、メッシュと配置を記録します
+	部品の選択に使う乱数は乱数の種、グリッドのインデックスと用途から作るので、
+	スレッドの数や実行順に関係なく同じ結果になります
+	*/
+	std::vector<TerrainSlice> slices(voxel->GetHeight());
+	const uint64_t terrainSeed = static_cast<uint32_t>(parameter->GetGeneratedRandomSeed());
+
+	voxel->ParallelEach([this, parameter, terrainSeed, &featureMask, &voxel, &slices](const FIntVector& location, const dungeon::Grid& grid)
 		{
-			const size_t gridIndex = mGenerator->GetVoxel()->Index(location);
+			TerrainSlice& slice = slices[location.Z];
+
+			const size_t gridIndex = voxel->Index(location);
+			const auto randomStream = [terrainSeed, gridIndex](const TerrainRandomStream stream)
+				{
+					return dungeon::Random::Stream(terrainSeed, gridIndex, static_cast<uint32_t>(stream));
+				};
+			const uint16_t features = featureMask.Get(gridIndex);
 			const float gridSize = parameter->GetGridSize();
 			const float halfGridSize = gridSize * 0.5f;
 			const FVector halfOffset(halfGridSize, halfGridSize, 0);
 			const FVector position = parameter->ToWorld(location);
 			const FVector centerPosition = position + halfOffset;
 
-			if (mOnAddSlope && grid.CanBuildSlope())
+			if (mOnAddSlope && (features & dungeon::FeatureMask::Slope))
 			{
 				/*
 				スロープのメッシュを生成
 				メッシュは原点からX軸とY軸方向に伸びており、面はZ軸が上面になっています。
 				*/
-				if (const FDungeonMeshParts* parts = parameter->SelectSlopeParts(gridIndex, grid, dungeon::Random::Instance()))
+				dungeon::Random slopeRandom = randomStream(TerrainRandomStream::Slope);
+				if (const FDungeonMeshParts* parts = parameter->SelectSlopeParts(gridIndex, grid, slopeRandom))
 				{
-					mOnAddSlope(parts->StaticMesh, parts->CalculateWorldTransform(centerPosition, grid.GetDirection()));
+					slice.AddMesh(TerrainCategory::Slope, parts->StaticMesh, parts->CalculateWorldTransform(centerPosition, grid.GetDirection()));
 				}
 			}
-			else if (mOnAddFloor && grid.CanBuildFloor(mGenerator->GetVoxel()->Get(location.X, location.Y, location.Z - 1), true))
+			else if (mOnAddFloor && (features & dungeon::FeatureMask::FloorMesh))
 			{
 				/*
 				床のメッシュを生成
 				メッシュは原点からX軸とY軸方向に伸びており、面はZ軸が上面になっています。
 				*/
-				if (const FDungeonMeshParts* parts = parameter->SelectFloorParts(gridIndex, grid, dungeon::Random::Instance()))
+				dungeon::Random floorRandom = randomStream(TerrainRandomStream::Floor);
+				if (const FDungeonMeshParts* parts = parameter->SelectFloorParts(gridIndex, grid, floorRandom))
 				{
-					mOnAddFloor(parts->StaticMesh, parts->CalculateWorldTransform(centerPosition, grid.GetDirection()));
+					slice.AddMesh(TerrainCategory::Floor, parts->StaticMesh, parts->CalculateWorldTransform(centerPosition, grid.GetDirection()));
 				}
 			}
 
@@ -264,35 +428,36 @@ void CDungeonGeneratorCore::AddTerrain()
 			*/
 			if (mOnAddWall)
 			{
-				if (const FDungeonMeshParts* parts = parameter->SelectWallParts(gridIndex, grid, dungeon::Random::Instance()))
+				dungeon::Random wallRandom = randomStream(TerrainRandomStream::Wall);
+				if (const FDungeonMeshParts* parts = parameter->SelectWallParts(gridIndex, grid, wallRandom))
 				{
-					if (grid.CanBuildWall(mGenerator->GetVoxel()->Get(location.X, location.Y - 1, location.Z), dungeon::Direction::North, parameter->MergeRooms))
+					if (features & dungeon::FeatureMask::WallNorth)
 					{
 						// 北側の壁
 						FVector wallPosition = centerPosition;
 						wallPosition.Y -= halfGridSize;
-						mOnAddWall(parts->StaticMesh, parts->CalculateWorldTransform(wallPosition, 0.f));
+						slice.AddMesh(TerrainCategory::Wall, parts->StaticMesh, parts->CalculateWorldTransform(wallPosition, 0.f));
 					}
-					if (grid.CanBuildWall(mGenerator->GetVoxel()->Get(location.X, location.Y + 1, location.Z), dungeon::Direction::South, parameter->MergeRooms))
+					if (features & dungeon::FeatureMask::WallSouth)
 					{
 						// 南側の壁
 						FVector wallPosition = centerPosition;
 						wallPosition.Y += halfGridSize;
-						mOnAddWall(parts->StaticMesh, parts->CalculateWorldTransform(wallPosition, 180.f));
+						slice.AddMesh(TerrainCategory::Wall, parts->StaticMesh, parts->CalculateWorldTransform(wallPosition, 180.f));
 					}
-					if (grid.CanBuildWall(mGenerator->GetVoxel()->Get(location.X + 1, location.Y, location.Z), dungeon::Direction::East, parameter->MergeRooms))
+					if (features & dungeon::FeatureMask::WallEast)
 					{
 						// 東側の壁
 						FVector wallPosition = centerPosition;
 						wallPosition.X += halfGridSize;
-						mOnAddWall(parts->StaticMesh, parts->CalculateWorldTransform(wallPosition, 90.f));
+						slice.AddMesh(TerrainCategory::Wall, parts->StaticMesh, parts->CalculateWorldTransform(wallPosition, 90.f));
 					}
-					if (grid.CanBuildWall(mGenerator->GetVoxel()->Get(location.X - 1, location.Y, location.Z), dungeon::Direction::West, parameter->MergeRooms))
+					if (features & dungeon::FeatureMask::WallWest)
 					{
 						// 西側の壁
 						FVector wallPosition = centerPosition;
 						wallPosition.X -= halfGridSize;
-						mOnAddWall(parts->StaticMesh, parts->CalculateWorldTransform(wallPosition, -90.f));
+						slice.AddMesh(TerrainCategory::Wall, parts->StaticMesh, parts->CalculateWorldTransform(wallPosition, -90.f));
 					}
 				}
 			}
@@ -303,59 +468,52 @@ void CDungeonGeneratorCore::AddTerrain()
 			*/
 			if (mOnResetPillar)
 			{
-				FVector wallVector(0.f);
-				uint8_t wallCount = 0;
-				bool onFloor = false;
-				uint32_t pillarGridHeight = 1;
-				for (int_fast8_t dy = -1; dy <= 0; ++dy)
+				const uint8_t wallCount = featureMask.GetPillarWallCount(gridIndex);
+				const bool onFloor = (features & dungeon::FeatureMask::PillarOnFloor) != 0;
+				if (onFloor && 0 < wallCount && wallCount < 4)
 				{
-					for (int_fast8_t dx = -1; dx <= 0; ++dx)
+					// 柱を置くグリッドだけ壁の向きと天井の高さを調べます
+					FVector wallVector(0.f);
+					uint32_t pillarGridHeight = 1;
+					for (int_fast8_t dy = -1; dy <= 0; ++dy)
 					{
-						// 壁の数を調べます
-						const auto& result = mGenerator->GetVoxel()->Get(location.X + dx, location.Y + dy, location.Z);
-						if (grid.CanBuildPillar(result))
-						{
-							wallVector += FVector(static_cast<float>(dx) + 0.5f, static_cast<float>(dy) + 0.5f, 0.f);
-							++wallCount;
-						}
-
-						// 床を調べます
-						const auto& baseFloorGrid = mGenerator->GetVoxel()->Get(location.X + dx, location.Y + dy, location.Z);
-						const auto& underFloorGrid = mGenerator->GetVoxel()->Get(location.X + dx, location.Y + dy, location.Z - 1);
-						if (baseFloorGrid.CanBuildSlope() || baseFloorGrid.CanBuildFloor(underFloorGrid, false))
+						for (int_fast8_t dx = -1; dx <= 0; ++dx)
 						{
-							onFloor = true;
+							// 壁の向きを調べます
+							const auto& baseFloorGrid = voxel->Get(location.X + dx, location.Y + dy, location.Z);
+							if (grid.CanBuildPillar(baseFloorGrid))
+							{
+								wallVector += FVector(static_cast<float>(dx) + 0.5f, static_cast<float>(dy) + 0.5f, 0.f);
+							}
 
-							// 天井の高さを調べます
-							uint32_t gridHeight = 1;
-							while (true)
+							// 床があれば記録した天井の高さを使います
+							const FIntVector baseFloorLocation(location.X + dx, location.Y + dy, location.Z);
+							if (!voxel->Contain(baseFloorLocation))
+								continue;
+							const size_t baseFloorIndex = voxel->Index(baseFloorLocation);
+							if (featureMask.Get(baseFloorIndex) & (dungeon::FeatureMask::Slope | dungeon::FeatureMask::Floor))
 							{
-								const auto& roofGrid = mGenerator->GetVoxel()->Get(location.X + dx, location.Y + dy, location.Z + gridHeight);
-								if (roofGrid.GetType() == dungeon::Grid::Type::OutOfBounds)
-									break;
-								if (!grid.CanBuildRoof(roofGrid, false))
-									break;
-								++gridHeight;
+								const uint32_t gridHeight = 1 + featureMask.GetHeadroom(baseFloorIndex, grid);
+								if (pillarGridHeight < gridHeight)
+									pillarGridHeight = gridHeight;
 							}
-							if (pillarGridHeight < gridHeight)
-								pillarGridHeight = gridHeight;
 						}
 					}
-				}
-				if (onFloor && 0 < wallCount && wallCount < 4)
-				{
+
 					wallVector.Normalize();
 
 					const FTransform transform(wallVector.Rotation(), position);
-					if (const FDungeonMeshParts* parts = parameter->SelectPillarParts(gridIndex, grid, dungeon::Random::Instance()))
+					dungeon::Random pillarRandom = randomStream(TerrainRandomStream::Pillar);
+					if (const FDungeonMeshParts* parts = parameter->SelectPillarParts(gridIndex, grid, pillarRandom))
 					{
-						mOnResetPillar(pillarGridHeight, parts->StaticMesh, parts->CalculateWorldTransform(transform));
+						slice.AddMesh(TerrainCategory::Pillar, parts->StaticMesh, parts->CalculateWorldTransform(transform), pillarGridHeight);
 					}
 
 					// 水平以外に対応が必要？
 					if (wallCount == 2)
 					{
-						if (const FDungeonActorParts* parts = parameter->SelectTorchParts(gridIndex, grid, dungeon::Random::Instance()))
+						dungeon::Random torchRandom = randomStream(TerrainRandomStream::Torch);
+						if (const FDungeonActorParts* parts = parameter->SelectTorchParts(gridIndex, grid, torchRandom))
 						{
 #if 0
 							const FTransform worldTransform = transform * parts->RelativeTransform;
@@ -368,51 +526,52 @@ void CDungeonGeneratorCore::AddTerrain()
 								transform.GetScale3D() * parts->RelativeTransform.GetScale3D()
 							);
 #endif
-							SpawnActor(parts->ActorClass, TEXT("Dungeon/Actors"), worldTransform);
+							slice.mActors.push_back({ parts->ActorClass, worldTransform, EDungeonRoomProps::None, false });
 						}
 					}
 				}
 			}
 
 			// 扉の生成通知
-			if (const FDungeonDoorActorParts* parts = parameter->SelectDoorParts(gridIndex, grid, dungeon::Random::Instance()))
+			dungeon::Random doorRandom = randomStream(TerrainRandomStream::Door);
+			if (const FDungeonDoorActorParts* parts = parameter->SelectDoorParts(gridIndex, grid, doorRandom))
 			{
 				const EDungeonRoomProps props = static_cast<EDungeonRoomProps>(grid.GetProps());
 
-				if (grid.CanBuildGate(mGenerator->GetVoxel()->Get(location.X, location.Y - 1, location.Z), dungeon::Direction::North))
+				if (features & dungeon::FeatureMask::GateNorth)
 				{
 					// 北側の扉
 					FVector doorPosition = position;
 					doorPosition.X += parameter->GridSize * 0.5f;
-					SpawnDoorActor(parts->ActorClass, parts->CalculateWorldTransform(doorPosition, 0.f), props);
+					slice.mActors.push_back({ parts->ActorClass, parts->CalculateWorldTransform(doorPosition, 0.f), props, true });
 				}
-				if (grid.CanBuildGate(mGenerator->GetVoxel()->Get(location.X, location.Y + 1, location.Z), dungeon::Direction::South))
+				if (features & dungeon::FeatureMask::GateSouth)
 				{
 					// 南側の扉
 					FVector doorPosition = position;
 					doorPosition.X += parameter->GridSize * 0.5f;
 					doorPosition.Y += parameter->GridSize;
-					SpawnDoorActor(parts->ActorClass, parts->CalculateWorldTransform(doorPosition, 180.f), props);
+					slice.mActors.push_back({ parts->ActorClass, parts->CalculateWorldTransform(doorPosition, 180.f), props, true });
 				}
-				if (grid.CanBuildGate(mGenerator->GetVoxel()->Get(location.X + 1, location.Y, location.Z), dungeon::Direction::East))
+				if (features & dungeon::FeatureMask::GateEast)
 				{
 					// 東側の扉
 					FVector doorPosition = position;
 					doorPosition.X += parameter->GridSize;
 					doorPosition.Y += parameter->GridSize * 0.5f;
-					SpawnDoorActor(parts->ActorClass, parts->CalculateWorldTransform(doorPosition, 90.f), props);
+					slice.mActors.push_back({ parts->ActorClass, parts->CalculateWorldTransform(doorPosition, 90.f), props, true });
 				}
-				if (grid.CanBuildGate(mGenerator->GetVoxel()->Get(location.X - 1, location.Y, location.Z), dungeon::Direction::West))
+				if (features & dungeon::FeatureMask::GateWest)
 				{
 					// 西側の扉
 					FVector doorPosition = position;
 					doorPosition.Y += parameter->GridSize * 0.5f;
-					SpawnDoorActor(parts->ActorClass, parts->CalculateWorldTransform(doorPosition, -90.f), props);
+					slice.mActors.push_back({ parts->ActorClass, parts->CalculateWorldTransform(doorPosition, -90.f), props, true });
 				}
 			}
 
 			// 屋根のメッシュ生成通知
-			if (grid.CanBuildRoof(mGenerator->GetVoxel()->Get(location.X, location.Y, location.Z + 1), true))
+			if (features & dungeon::FeatureMask::RoofMesh)
 			{
 				/*
 				壁のメッシュを生成
@@ -424,12 +583,10 @@ void CDungeonGeneratorCore::AddTerrain()
 				{
 					if (mOnAddRoomRoof)
 					{
-						if (const FDungeonMeshPartsWithDirection* parts = parameter->SelectRoomRoofParts(gridIndex, grid, dungeon::Random::Instance()))
+						dungeon::Random roofRandom = randomStream(TerrainRandomStream::RoomRoof);
+						if (const FDungeonMeshPartsWithDirection* parts = parameter->SelectRoomRoofParts(gridIndex, grid, roofRandom))
 						{
-							mOnAddRoomRoof(
-								parts->StaticMesh,
-								parts->CalculateWorldTransform(dungeon::Random::Instance(), transform)
-							);
+							slice.AddMesh(TerrainCategory::RoomRoof, parts->StaticMesh, parts->CalculateWorldTransform(roofRandom, transform));
 						}
 					}
 				}
@@ -437,12 +594,10 @@ void CDungeonGeneratorCore::AddTerrain()
 				{
 					if (mOnAddAisleRoof)
 					{
-						if (const FDungeonMeshPartsWithDirection* parts = parameter->SelectAisleRoofParts(gridIndex, grid, dungeon::Random::Instance()))
+						dungeon::Random roofRandom = randomStream(TerrainRandomStream::AisleRoof);
+						if (const FDungeonMeshPartsWithDirection* parts = parameter->SelectAisleRoofParts(gridIndex, grid, roofRandom))
 						{
-							mOnAddAisleRoof(
-								parts->StaticMesh,
-								parts->CalculateWorldTransform(dungeon::Random::Instance(), transform)
-							);
+							slice.AddMesh(TerrainCategory::AisleRoof, parts->StaticMesh, parts->CalculateWorldTransform(roofRandom, transform));
 						}
 					}
 				}
@@ -450,18 +605,52 @@ void CDungeonGeneratorCore::AddTerrain()
 #if 0
 				if (mOnResetChandelier)
 				{
-					if (const FDungeonActorParts* parts = parameter->SelectChandelierParts(dungeon::Random::Instance()))
+					if (const FDungeonActorParts* parts = parameter->SelectChandelierParts(random))
 					{
 						mOnResetChandelier(parts->ActorClass, worldTransform);
 					}
 				}
 #endif
 			}
-
-			return true;
 		}
 	);
 
+	/*
+	ゲームスレッドでメッシュ毎にまとめて通知します
+	*/
+	const std::pair<TerrainCategory, const AddStaticMeshEvent*> meshEvents[] = {
+		{ TerrainCategory::Floor, &mOnAddFloor },
+		{ TerrainCategory::Slope, &mOnAddSlope },
+		{ TerrainCategory::Wall, &mOnAddWall },
+		{ TerrainCategory::RoomRoof, &mOnAddRoomRoof },
+		{ TerrainCategory::AisleRoof, &mOnAddAisleRoof },
+	};
+	for (const auto& meshEvent : meshEvents)
+	{
+		for (const TerrainMeshBuffer& buffer : MergeTerrainSlices(slices, meshEvent.first))
+		{
+			for (const FTransform& transform : buffer.mTransforms)
+				(*meshEvent.second)(buffer.mStaticMesh, transform);
+		}
+	}
+	for (const TerrainMeshBuffer& buffer : MergeTerrainSlices(slices, TerrainCategory::Pillar))
+	{
+		for (size_t i = 0; i < buffer.mTransforms.size(); ++i)
+			mOnResetPillar(buffer.mPillarHeights[i], buffer.mStaticMesh, buffer.mTransforms[i]);
+	}
+
+	// アクターは下の階層から順番に生成する
+	for (const TerrainSlice& slice : slices)
+	{
+		for (const TerrainActorPlacement& actor : slice.mActors)
+		{
+			if (actor.mDoor)
+				SpawnDoorActor(actor.mActorClass, actor.mTransform, actor.mProps);
+			else
+				SpawnActor(actor.mActorClass, TEXT("Dungeon/Actors"), actor.mTransform);
+		}
+	}
+
 	// RoomSensorActorを生成
 	mGenerator->ForEach([this, parameter](const std::shared_ptr<const dungeon::Room>& room)
 		{
@@ -601,6 +790,7 @@ void CDungeonGeneratorCore::AddObject()
 
 void CDungeonGeneratorCore::Clear()
 {
+	mFeatureMask.reset();
 	mGenerator.reset();
 	mParameter = nullptr;
 }
@@ -729,6 +919,10 @@ void CDungeonGeneratorCore::MovePlayerStart()
 ////////////////////////////////////////////////////////////////////////////////
 AActor* CDungeonGeneratorCore::SpawnActor(UClass* actorClass, const FName& folderPath, const FTransform& transform, const ESpawnActorCollisionHandlingMethod spawnActorCollisionHandlingMethod) const
 {
+	// プールに使っていないアクターがあれば再利用します
+	if (AActor* actor = mActorPool->Acquire(actorClass, transform))
+		return actor;
+
 	AActor* actor = SpawnActorDeferred<AActor>(actorClass, folderPath, transform, spawnActorCollisionHandlingMethod);
 	//ESpawnActorCollisionHandlingMethod::AlwaysSpawn
 	//ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding
@@ -736,20 +930,31 @@ AActor* CDungeonGeneratorCore::SpawnActor(UClass* actorClass, const FName& folde
 	if (!IsValid(actor))
 		return nullptr;
 	actor->FinishSpawning(transform);
+	mActorPool->AddActive(actor);
 	return actor;
 }
 
 AStaticMeshActor* CDungeonGeneratorCore::SpawnStaticMeshActor(UStaticMesh* staticMesh, const FName& folderPath, const FTransform& transform, const ESpawnActorCollisionHandlingMethod spawnActorCollisionHandlingMethod) const
 {
+	const auto setStaticMesh = [staticMesh](AActor* actor)
+		{
+			UStaticMeshComponent* mesh = CastChecked<AStaticMeshActor>(actor)->GetStaticMeshComponent();
+			if (IsValid(mesh))
+				mesh->SetStaticMesh(staticMesh);
+		};
+
+	// プールに使っていないアクターがあればメッシュを差し替えて再利用します
+	if (AActor* pooledActor = mActorPool->Acquire(AStaticMeshActor::StaticClass(), transform, setStaticMesh))
+		return CastChecked<AStaticMeshActor>(pooledActor);
+
 	AStaticMeshActor* actor = SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), folderPath, transform, spawnActorCollisionHandlingMethod);
 	if (!IsValid(actor))
 		return nullptr;
 
-	UStaticMeshComponent* mesh = actor->GetStaticMeshComponent();
-	if (IsValid(mesh))
-		mesh->SetStaticMesh(staticMesh);
+	setStaticMesh(actor);
 
 	actor->FinishSpawning(transform);
+	mActorPool->AddActive(actor);
 	return actor;
 }
 
@@ -766,19 +971,29 @@ void CDungeonGeneratorCore::SpawnActorOnFloor(UClass* actorClass, const FTransfo
 
 void CDungeonGeneratorCore::SpawnDoorActor(UClass* actorClass, const FTransform& transform, EDungeonRoomProps props) const
 {
+	const auto initialize = [this, props](AActor* actor)
+		{
+			ADungeonDoor* door = CastChecked<ADungeonDoor>(actor);
+			door->Initialize(props);
+
+			if (mOnResetDoor)
+			{
+				mOnResetDoor(door, props);
+			}
+		};
+
+	if (mActorPool->Acquire(actorClass, transform, initialize))
+		return;
+
 	ADungeonDoor* actor = SpawnActorDeferred<ADungeonDoor>(actorClass, TEXT("Dungeon/Actors"), transform, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
 	if (IsValid(actor))
 	{
-		actor->Initialize(props);
-
-		if (mOnResetDoor)
-		{
-			mOnResetDoor(actor, props);
-		}
+		initialize(actor);
 	}
 	if (IsValid(actor))
 	{
 		actor->FinishSpawning(transform);
+		mActorPool->AddActive(actor);
 	}
 }
 
@@ -794,20 +1009,72 @@ void CDungeonGeneratorCore::SpawnRoomSensorActor(
 	const uint8 deepestDepthFromStart) const
 {
 	const FTransform transform(center);
+	const auto initialize = [&](AActor* actor)
+		{
+			CastChecked<ADungeonRoomSensor>(actor)->Initialize(identifier.Get(), extent, parts, item, branchId, depthFromStart, deepestDepthFromStart);
+		};
+
+	if (mActorPool->Acquire(actorClass, transform, initialize))
+		return;
+
 	ADungeonRoomSensor* actor = SpawnActorDeferred<ADungeonRoomSensor>(actorClass, TEXT("Dungeon/Sensors"), transform, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
 	if (IsValid(actor))
 	{
-		actor->Initialize(identifier.Get(), extent, parts, item, branchId, depthFromStart, deepestDepthFromStart);
+		initialize(actor);
 	}
 	if (IsValid(actor))
 	{
 		actor->FinishSpawning(transform);
+		mActorPool->AddActive(actor);
 	}
 };
 
+void CDungeonGeneratorCore::PrewarmActors(UClass* actorClass, const FName& folderPath, const int32 count) const
+{
+	// 使っていないアクターとしてプールに生成しておきます
+	for (int32 i = mActorPool->GetInactiveNum(actorClass); i < count; ++i)
+	{
+		AActor* actor = SpawnActorDeferred<AActor>(actorClass, folderPath, FTransform::Identity, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (!IsValid(actor))
+			break;
+		actor->FinishSpawning(FTransform::Identity);
+		mActorPool->AddInactive(actor);
+	}
+}
+
+void CDungeonGeneratorCore::EnableAisleSearchHeatmap(const bool enable)
+{
+	mAisleSearchHeatmap = enable;
+}
+
+void CDungeonGeneratorCore::ReleaseSpawnedActors() const
+{
+	mActorPool->ReleaseAll();
+
+	// 外部で破棄されたアクターを登録から取り除きます
+	mSpawnedActors.RemoveAllSwap([](const TWeakObjectPtr<AActor>& spawnedActor)
+		{
+			return !spawnedActor.IsValid();
+		}
+	);
+}
+
+void CDungeonGeneratorCore::DestroyInactiveActors(UClass* actorClass) const
+{
+	mActorPool->DestroyInactive(actorClass);
+}
+
 void CDungeonGeneratorCore::DestroySpawnedActors() const
 {
-	DestroySpawnedActors(mWorld.Get());
+	mActorPool->Reset();
+
+	// 登録したアクターだけを破棄するのでワールド全体を走査しません
+	for (const TWeakObjectPtr<AActor>& spawnedActor : mSpawnedActors)
+	{
+		DestroySpawnedActor(spawnedActor.Get());
+	}
+	mSpawnedActors.Reset();
+	mFoundActors.Reset();
 }
 
 void CDungeonGeneratorCore::DestroySpawnedActors(UWorld* world)
@@ -819,15 +1086,20 @@ void CDungeonGeneratorCore::DestroySpawnedActors(UWorld* world)
 	UGameplayStatics::GetAllActorsWithTag(world, DungeonGeneratorTag, actors);
 	for (AActor* actor : actors)
 	{
-		if (!IsValid(actor))
-			continue;
+		DestroySpawnedActor(actor);
+	}
+}
 
-		if (ADungeonRoomSensor* dungeonRoomSensor = Cast<ADungeonRoomSensor>(actor))
-		{
-			dungeonRoomSensor->Finalize();
-		}
-		actor->Destroy();
+void CDungeonGeneratorCore::DestroySpawnedActor(AActor* actor)
+{
+	if (!IsValid(actor))
+		return;
+
+	if (ADungeonRoomSensor* dungeonRoomSensor = Cast<ADungeonRoomSensor>(actor))
+	{
+		dungeonRoomSensor->Finalize();
 	}
+	actor->Destroy();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -873,7 +1145,7 @@ UTexture2D* CDungeonGeneratorCore::GenerateMiniMapTextureWithScale(uint32_t& wor
 UTexture2D* CDungeonGeneratorCore::GenerateMiniMapTexture(uint32_t worldToTextureScale, uint32_t textureWidthHeight, uint32_t currentLevel) const
 {
 	const UDungeonGenerateParameter* parameter = mParameter.Get();
-	if (!IsValid(parameter))
+	if (!IsValid(parameter) || mFeatureMask == nullptr)
 		return nullptr;
 
 	const size_t totalBufferSize = textureWidthHeight * textureWidthHeight;
@@ -929,6 +1201,9 @@ UTexture2D* CDungeonGeneratorCore::GenerateMiniMapTexture(uint32_t worldToTextur
 		}
 	};
 
+	// 地形と同じ判定結果から描画する
+	const dungeon::FeatureMask& featureMask = *mFeatureMask;
+
 	// 下の階層から描画する
 	const float paintRatio = 1.f / std::max(1.f, static_cast<float>(currentLevel));
 	for (uint32_t z = 0; z <= currentLevel; ++z)
@@ -954,32 +1229,29 @@ UTexture2D* CDungeonGeneratorCore::GenerateMiniMapTexture(uint32_t worldToTextur
 		{
 			for (uint32_t x = 0; x < voxel->GetWidth(); ++x)
 			{
-				const auto& grid = voxel->Get(x, y, z);
-				// slope
-				if (grid.CanBuildSlope() || grid.GetType() == dungeon::Grid::Type::Atrium)
-				{
-					rect(x, y, floorColor);
-				}
-				// floor
-				else if (grid.CanBuildFloor(voxel->Get(x, y, z - 1), false))
+				const size_t index = voxel->Index(x, y, z);
+				const uint16_t features = featureMask.Get(index);
+
+				// slope and floor
+				if ((features & (dungeon::FeatureMask::Slope | dungeon::FeatureMask::Floor)) || voxel->Get(x, y, z).GetType() == dungeon::Grid::Type::Atrium)
 				{
 					rect(x, y, floorColor);
 				}
 
 				// wall
-				if (grid.CanBuildWall(voxel->Get(x, y - 1, z), dungeon::Direction::North, parameter->MergeRooms))
+				if (features & dungeon::FeatureMask::WallNorth)
 				{
 					line(x, y, dungeon::Direction::North, wallColor);
 				}
-				if (grid.CanBuildWall(voxel->Get(x, y + 1, z), dungeon::Direction::South, parameter->MergeRooms))
+				if (features & dungeon::FeatureMask::WallSouth)
 				{
 					line(x, y, dungeon::Direction::South, wallColor);
 				}
-				if (grid.CanBuildWall(voxel->Get(x + 1, y, z), dungeon::Direction::East, parameter->MergeRooms))
+				if (features & dungeon::FeatureMask::WallEast)
 				{
 					line(x, y, dungeon::Direction::East, wallColor);
 				}
-				if (grid.CanBuildWall(voxel->Get(x - 1, y, z), dungeon::Direction::West, parameter->MergeRooms))
+				if (features & dungeon::FeatureMask::WallWest)
 				{
 					line(x, y, dungeon::Direction::West, wallColor);
 				}
@@ -1137,6 +1409,7 @@ void CDungeonGeneratorCore::SyncLoadStreamLevels()
 					for (AActor* actor : loadedLevel->Actors)
 					{
 						actor->Tags.Add(GetDungeonGeneratorTag());
+						mSpawnedActors.Add(actor);
 
 						const FName folderPath(FString(TEXT("Dungeon/Levels/")) + folder);
 						actor->SetFolderPath(folderPath);
@@ -1238,7 +1511,7 @@ void CDungeonGeneratorCore::UnloadStreamLevelImplement(UWorld* world, const FSof
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #if WITH_EDITOR
-void CDungeonGeneratorCore::DrawDebugInformation(const bool showRoomAisleInfomation, const bool showVoxelGridType) const
+void CDungeonGeneratorCore::DrawDebugInformation(const bool showRoomAisleInfomation, const bool showVoxelGridType, const bool showAisleSearchHeatmap) const
 {
 	// 部屋と接続情報のデバッグ情報を表示します
 	if (showRoomAisleInfomation)
@@ -1248,6 +1521,10 @@ void CDungeonGeneratorCore::DrawDebugInformation(const bool showRoomAisleInfomat
 	if (showVoxelGridType)
 		DrawVoxelGridType();
 
+	// 通路の探索でボクセルグリッドを展開した回数を表示します
+	if (showAisleSearchHeatmap)
+		DrawAisleSearchHeatmap();
+
 #if 0
 	// ダンジョン全体の領域を可視化
 	{
@@ -1373,4 +1650,47 @@ void CDungeonGeneratorCore::DrawVoxelGridType() const
 		}
 	);
 }
+
+void CDungeonGeneratorCore::DrawAisleSearchHeatmap() const
+{
+#if DUNGEON_GENERATOR_SEARCH_STATISTICS
+	const UDungeonGenerateParameter* parameter = mParameter.Get();
+	if (!IsValid(parameter))
+		return;
+
+	UWorld* world = mWorld.Get();
+	if (!IsValid(world))
+		return;
+
+	check(mGenerator);
+
+	const std::vector<uint32_t>& heatmap = mGenerator->GetSearchHeatmap();
+	const uint32_t maxCount = heatmap.empty() ? 0 : *std::max_element(heatmap.begin(), heatmap.end());
+	if (maxCount <= 0)
+		return;
+
+	const std::shared_ptr<dungeon::Voxel>& voxel = mGenerator->GetVoxel();
+	voxel->Each([world, parameter, &voxel, &heatmap, maxCount](const FIntVector& location, const dungeon::Grid&)
+		{
+			const uint32_t count = heatmap[voxel->Index(location)];
+			if (count > 0)
+			{
+				const FVector halfGrid(parameter->GetGridSize() / 2.f, parameter->GetGridSize() / 2.f, parameter->GetGridSize() / 2.f);
+				const float ratio = static_cast<float>(count) / static_cast<float>(maxCount);
+				UKismetSystemLibrary::DrawDebugBox(
+					world,
+					FVector(location.X, location.Y, location.Z) * parameter->GetGridSize() + halfGrid,
+					halfGrid * (0.2 + 0.7 * ratio),
+					FLinearColor::LerpUsingHSV(FLinearColor::Blue, FLinearColor::Red, ratio),
+					FRotator::ZeroRotator,
+					0.f,
+					2.f
+				);
+			}
+
+			return true;
+		}
+	);
+#endif
+}
 #endif
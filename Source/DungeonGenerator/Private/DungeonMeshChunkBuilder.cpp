@@ -0,0 +1,229 @@
+/**
+地形のメッシュをチャンク毎にまとめるクラス ソースファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#include "DungeonMeshChunkBuilder.h"
+#include <Engine/StaticMesh.h>
+#include <MeshDescription.h>
+#include <Misc/EngineVersionComparison.h>
+#include <PhysicsEngine/BodySetup.h>
+#include <StaticMeshAttributes.h>
+#include <StaticMeshResources.h>
+
+namespace
+{
+#if UE_VERSION_OLDER_THAN(5, 0, 0)
+	using MeshVector3 = FVector;
+	using MeshVector2 = FVector2D;
+#else
+	using MeshVector3 = FVector3f;
+	using MeshVector2 = FVector2f;
+#endif
+
+	// 平面のメッシュでもコリジョンが潰れないようにするボックスの最小の厚み
+	constexpr float MinimumBoxThickness = 1.f;
+
+	const FStaticMeshLODResources* GetSourceLODResources(const UStaticMesh* staticMesh)
+	{
+#if UE_VERSION_OLDER_THAN(5, 0, 0)
+		const FStaticMeshRenderData* renderData = staticMesh->RenderData.Get();
+#else
+		const FStaticMeshRenderData* renderData = staticMesh->GetRenderData();
+#endif
+		if (renderData == nullptr || renderData->LODResources.Num() <= 0)
+			return nullptr;
+		return &renderData->LODResources[0];
+	}
+}
+
+CDungeonMeshChunkBuilder::CDungeonMeshChunkBuilder(const float gridSize, const int32 chunkSize)
+	: mGridSize(gridSize)
+	, mChunkWorldSize(gridSize * static_cast<float>(FMath::Max(chunkSize, 1)))
+{
+}
+
+bool CDungeonMeshChunkBuilder::CanMerge(const UStaticMesh* staticMesh)
+{
+	if (!IsValid(staticMesh) || GetSourceLODResources(staticMesh) == nullptr)
+		return false;
+
+	// クック済みのメッシュはCPUアクセスを許可していないと頂点を読めない
+	return !FPlatformProperties::RequiresCookedData() || staticMesh->bAllowCPUAccess;
+}
+
+bool CDungeonMeshChunkBuilder::Add(UStaticMesh* staticMesh, const FTransform& transform)
+{
+	if (!CanMerge(staticMesh))
+		return false;
+
+	mChunks.FindOrAdd(ToChunk(transform.GetLocation())).Add({ staticMesh, transform });
+	return true;
+}
+
+void CDungeonMeshChunkBuilder::Build(UObject* outer, const BuildEvent& function)
+{
+	for (const auto& chunk : mChunks)
+	{
+		const FVector origin(
+			static_cast<float>(chunk.Key.X) * mChunkWorldSize,
+			static_cast<float>(chunk.Key.Y) * mChunkWorldSize,
+			static_cast<float>(chunk.Key.Z) * mGridSize
+		);
+		if (UStaticMesh* staticMesh = BuildChunk(outer, origin, chunk.Value))
+		{
+			function(staticMesh, origin);
+		}
+	}
+	Clear();
+}
+
+void CDungeonMeshChunkBuilder::Clear()
+{
+	mChunks.Empty();
+}
+
+FIntVector CDungeonMeshChunkBuilder::ToChunk(const FVector& location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(location.X / mChunkWorldSize),
+		FMath::FloorToInt(location.Y / mChunkWorldSize),
+		FMath::FloorToInt(location.Z / mGridSize)
+	);
+}
+
+UStaticMesh* CDungeonMeshChunkBuilder::BuildChunk(UObject* outer, const FVector& origin, const TArray<Instance>& instances)
+{
+	FMeshDescription meshDescription;
+	FStaticMeshAttributes attributes(meshDescription);
+	attributes.Register();
+
+	auto positions = attributes.GetVertexPositions();
+	auto normals = attributes.GetVertexInstanceNormals();
+	auto tangents = attributes.GetVertexInstanceTangents();
+	auto binormalSigns = attributes.GetVertexInstanceBinormalSigns();
+	auto uvs = attributes.GetVertexInstanceUVs();
+	auto materialSlotNames = attributes.GetPolygonGroupMaterialSlotNames();
+
+	TArray<FStaticMaterial> materials;
+	TMap<UMaterialInterface*, FPolygonGroupID> polygonGroups;
+	FKAggregateGeom aggregateGeom;
+	TArray<uint32> indices;
+	TArray<FVertexInstanceID> vertexInstanceIDs;
+
+	for (const Instance& instance : instances)
+	{
+		const FStaticMeshLODResources* lodResources = GetSourceLODResources(instance.mStaticMesh);
+		if (lodResources == nullptr)
+			continue;
+
+		// チャンクの原点からの相対座標にします
+		FTransform transform = instance.mTransform;
+		transform.AddToTranslation(-origin);
+		const bool mirrored = transform.GetDeterminant() < 0.f;
+		const FVector inverseScale = FTransform::GetSafeScaleReciprocal(transform.GetScale3D());
+
+		// 頂点を変換して追加
+		const FPositionVertexBuffer& positionBuffer = lodResources->VertexBuffers.PositionVertexBuffer;
+		const FStaticMeshVertexBuffer& vertexBuffer = lodResources->VertexBuffers.StaticMeshVertexBuffer;
+		const uint32 vertexCount = positionBuffer.GetNumVertices();
+		const bool hasUV = vertexBuffer.GetNumTexCoords() > 0;
+		vertexInstanceIDs.Reset(vertexCount);
+		for (uint32 i = 0; i < vertexCount; ++i)
+		{
+			const FVertexID vertexID = meshDescription.CreateVertex();
+			positions[vertexID] = MeshVector3(transform.TransformPosition(FVector(positionBuffer.VertexPosition(i))));
+
+			const FVertexInstanceID vertexInstanceID = meshDescription.CreateVertexInstance(vertexID);
+			const FVector normal(MeshVector3(vertexBuffer.VertexTangentZ(i)));
+			const FVector tangent(MeshVector3(vertexBuffer.VertexTangentX(i)));
+			const float binormalSign = vertexBuffer.VertexTangentZ(i).W < 0.f ? -1.f : 1.f;
+			normals[vertexInstanceID] = MeshVector3(transform.GetRotation().RotateVector(normal * inverseScale).GetSafeNormal());
+			tangents[vertexInstanceID] = MeshVector3(transform.TransformVector(tangent).GetSafeNormal());
+			binormalSigns[vertexInstanceID] = mirrored ? -binormalSign : binormalSign;
+			uvs.Set(vertexInstanceID, 0, hasUV ? MeshVector2(vertexBuffer.GetVertexUV(i, 0)) : MeshVector2(0.f, 0.f));
+			vertexInstanceIDs.Add(vertexInstanceID);
+		}
+
+		// マテリアル毎のポリゴングループに三角形を追加
+		indices.Reset();
+		lodResources->IndexBuffer.GetCopy(indices);
+		for (const FStaticMeshSection& section : lodResources->Sections)
+		{
+			UMaterialInterface* material = instance.mStaticMesh->GetMaterial(section.MaterialIndex);
+			FPolygonGroupID polygonGroupID;
+			if (const FPolygonGroupID* found = polygonGroups.Find(material))
+			{
+				polygonGroupID = *found;
+			}
+			else
+			{
+				const FName slotName(TEXT("Material"), materials.Num());
+				polygonGroupID = meshDescription.CreatePolygonGroup();
+				materialSlotNames[polygonGroupID] = slotName;
+				materials.Add(FStaticMaterial(material, slotName, slotName));
+				polygonGroups.Add(material, polygonGroupID);
+			}
+
+			for (uint32 triangle = 0; triangle < section.NumTriangles; ++triangle)
+			{
+				const uint32 firstIndex = section.FirstIndex + triangle * 3;
+				FVertexInstanceID vertexInstances[3] = {
+					vertexInstanceIDs[indices[firstIndex + 0]],
+					vertexInstanceIDs[indices[firstIndex + 1]],
+					vertexInstanceIDs[indices[firstIndex + 2]]
+				};
+				// 鏡映したメッシュは面の向きを保つために巻き順を反転します
+				if (mirrored)
+					Swap(vertexInstances[1], vertexInstances[2]);
+				meshDescription.CreateTriangle(polygonGroupID, MakeArrayView(vertexInstances, 3));
+			}
+		}
+
+		// コリジョンは元のメッシュの境界をボックスに単純化します
+		const FBox bounds = instance.mStaticMesh->GetBoundingBox();
+		const FVector size = bounds.GetSize() * transform.GetScale3D().GetAbs();
+		FKBoxElem box(
+			FMath::Max(static_cast<float>(size.X), MinimumBoxThickness),
+			FMath::Max(static_cast<float>(size.Y), MinimumBoxThickness),
+			FMath::Max(static_cast<float>(size.Z), MinimumBoxThickness)
+		);
+		box.Center = transform.TransformPosition(bounds.GetCenter());
+		box.Rotation = transform.Rotator();
+		aggregateGeom.BoxElems.Add(box);
+	}
+
+	if (materials.Num() <= 0)
+		return nullptr;
+
+	UStaticMesh* staticMesh = NewObject<UStaticMesh>(outer, NAME_None, RF_Transient);
+#if UE_VERSION_OLDER_THAN(5, 0, 0)
+	staticMesh->StaticMaterials = materials;
+#else
+	staticMesh->SetStaticMaterials(materials);
+#endif
+
+	UStaticMesh::FBuildMeshDescriptionsParams params;
+	params.bBuildSimpleCollision = false;
+#if UE_VERSION_NEWER_THAN(5, 0, 0)
+	params.bFastBuild = true;
+#endif
+	TArray<const FMeshDescription*> meshDescriptions;
+	meshDescriptions.Add(&meshDescription);
+	staticMesh->BuildFromMeshDescriptions(meshDescriptions, params);
+
+	// 単純化したコリジョンだけを使います
+	staticMesh->CreateBodySetup();
+	if (UBodySetup* bodySetup = staticMesh->GetBodySetup())
+	{
+		bodySetup->CollisionTraceFlag = CTF_UseSimpleAsComplex;
+		bodySetup->bNeverNeedsCookedCollisionData = true;
+		bodySetup->AggGeom = MoveTemp(aggregateGeom);
+		bodySetup->CreatePhysicsMeshes();
+	}
+
+	return staticMesh;
+}
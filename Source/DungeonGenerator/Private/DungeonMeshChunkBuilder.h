@@ -0,0 +1,91 @@
+/**
+地形のメッシュをチャンク毎にまとめるクラス ヘッダーファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#pragma once
+#include <CoreMinimal.h>
+#include <functional>
+
+// Forward declaration
+class UObject;
+class UStaticMesh;
+
+/**
+地形のメッシュをチャンク毎にまとめるクラス
+水平方向にチャンクの大きさのグリッド、垂直方向に1グリッドの範囲に置かれたメッシュを
+マテリアル毎のセクションを持つ一つのスタティックメッシュに結合します。
+コリジョンは元のメッシュの境界を変換したボックスに単純化します。
+ボックスでは登れなくなるので、斜面や階段のメッシュは追加しないで下さい。
+*/
+class CDungeonMeshChunkBuilder final
+{
+public:
+	/**
+	チャンクのメッシュの生成通知
+	UStaticMesh*は生成したメッシュ、FVectorはメッシュの原点のワールド座標
+	*/
+	using BuildEvent = std::function<void(UStaticMesh*, const FVector&)>;
+
+public:
+	/**
+	コンストラクタ
+	\param[in]	gridSize	グリッドの大きさ
+	\param[in]	chunkSize	水平方向のチャンクのグリッド数
+	*/
+	CDungeonMeshChunkBuilder(const float gridSize, const int32 chunkSize);
+	CDungeonMeshChunkBuilder(const CDungeonMeshChunkBuilder&) = delete;
+	CDungeonMeshChunkBuilder& operator=(const CDungeonMeshChunkBuilder&) = delete;
+
+	/**
+	デストラクタ
+	*/
+	~CDungeonMeshChunkBuilder() = default;
+
+	/**
+	メッシュを結合できるか調べます
+	クック済みの実行環境ではCPUから頂点を参照できるメッシュだけを結合できます
+	\param[in]	staticMesh	スタティックメッシュ
+	\return		trueならば結合できる
+	*/
+	static bool CanMerge(const UStaticMesh* staticMesh);
+
+	/**
+	メッシュを配置するチャンクに追加します
+	\param[in]	staticMesh	スタティックメッシュ
+	\param[in]	transform	ワールドトランスフォーム
+	\return		falseならば結合できないメッシュなので追加していない
+	*/
+	bool Add(UStaticMesh* staticMesh, const FTransform& transform);
+
+	/**
+	チャンク毎にメッシュを生成します
+	追加したメッシュは生成後に破棄します
+	\param[in]	outer		生成するメッシュのアウター
+	\param[in]	function	チャンクのメッシュの生成通知
+	*/
+	void Build(UObject* outer, const BuildEvent& function);
+
+	/**
+	追加したメッシュを破棄します
+	*/
+	void Clear();
+
+private:
+	struct Instance final
+	{
+		UStaticMesh* mStaticMesh;
+		FTransform mTransform;
+	};
+
+	FIntVector ToChunk(const FVector& location) const;
+	static UStaticMesh* BuildChunk(UObject* outer, const FVector& origin, const TArray<Instance>& instances);
+
+private:
+	float mGridSize;
+	float mChunkWorldSize;
+	TMap<FIntVector, TArray<Instance>> mChunks;
+};
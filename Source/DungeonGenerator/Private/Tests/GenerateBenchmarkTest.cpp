@@ -0,0 +1,140 @@
+/**
+ボクセルのメモリ配置毎の生成時間の計測 ソースファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#include "Core/Generator.h"
+#include "Core/GenerateParameter.h"
+#include "Core/Voxel.h"
+#include <HAL/PlatformTime.h>
+#include <Misc/AutomationTest.h>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// 計測に使う乱数の種の数（種は1から順番に使います）
+	constexpr int32 BenchmarkSeedCount = 8;
+
+	// 計測を繰り返す回数（最も速い回を結果にします）
+	constexpr int32 BenchmarkIterationCount = 3;
+
+	/*
+	計測用の生成パラメータを作ります
+	部屋の数や大きさは固定しているので、同じ種ならば毎回同じダンジョンになります
+	*/
+	dungeon::GenerateParameter MakeBenchmarkParameter(const int32 seed, const dungeon::VoxelLayout layout)
+	{
+		dungeon::GenerateParameter parameter;
+		parameter.mRandom.SetSeed(seed);
+		parameter.mNumberOfCandidateFloors = 3;
+		parameter.mNumberOfCandidateRooms = 16;
+		parameter.mMinRoomWidth = 4;
+		parameter.mMaxRoomWidth = 8;
+		parameter.mMinRoomDepth = 4;
+		parameter.mMaxRoomDepth = 8;
+		parameter.mMinRoomHeight = 2;
+		parameter.mMaxRoomHeight = 3;
+		parameter.mHorizontalRoomMargin = 1;
+		parameter.mVoxelLayout = layout;
+		return parameter;
+	}
+
+	/*
+	メッシュの配置と同じように、前後左右上下の隣接グリッドを参照しながら全てのグリッドを巡回します
+	\return		空白と隣接しているグリッドの数（最適化で巡回が消えないように結果を返します）
+	*/
+	size_t ScanNeighbours(const dungeon::Voxel& voxel)
+	{
+		static const FIntVector neighbours[] = {
+			FIntVector(1, 0, 0), FIntVector(-1, 0, 0),
+			FIntVector(0, 1, 0), FIntVector(0, -1, 0),
+			FIntVector(0, 0, 1), FIntVector(0, 0, -1)
+		};
+
+		size_t count = 0;
+		voxel.Each([&voxel, &count](const FIntVector& location, const dungeon::Grid& grid)
+			{
+				if (grid.GetType() == dungeon::Grid::Type::Empty)
+					return true;
+
+				for (const FIntVector& neighbour : neighbours)
+				{
+					const FIntVector toLocation = location + neighbour;
+					if (voxel.Contain(toLocation) && voxel.Get(toLocation.X, toLocation.Y, toLocation.Z).GetType() == dungeon::Grid::Type::Empty)
+						++count;
+				}
+				return true;
+			}
+		);
+		return count;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonGenerateBenchmarkTest, "DungeonGenerator.Core.GenerateBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FDungeonGenerateBenchmarkTest::RunTest(const FString& Parameters)
+{
+	static const struct
+	{
+		dungeon::VoxelLayout mLayout;
+		const TCHAR* mName;
+	} layouts[] = {
+		{ dungeon::VoxelLayout::Linear, TEXT("Linear") },
+		{ dungeon::VoxelLayout::Tiled, TEXT("Tiled") },
+		{ dungeon::VoxelLayout::Sparse, TEXT("Sparse") }
+	};
+
+	int32 failedCount = 0;
+	for (const auto& layout : layouts)
+	{
+		double bestGenerateSeconds = TNumericLimits<double>::Max();
+		double bestScanSeconds = TNumericLimits<double>::Max();
+		size_t scanResult = 0;
+
+		for (int32 iteration = 0; iteration < BenchmarkIterationCount; ++iteration)
+		{
+			double generateSeconds = 0.0;
+			double scanSeconds = 0.0;
+			scanResult = 0;
+
+			for (int32 seed = 1; seed <= BenchmarkSeedCount; ++seed)
+			{
+				const double generateStart = FPlatformTime::Seconds();
+				const auto generator = std::make_shared<dungeon::Generator>();
+				generator->Generate(MakeBenchmarkParameter(seed, layout.mLayout));
+				generateSeconds += FPlatformTime::Seconds() - generateStart;
+
+				if (generator->GetLastError() != dungeon::Generator::Error::Success)
+				{
+					AddError(FString::Printf(TEXT("%s: generation failed (seed %d)"), layout.mName, seed));
+					++failedCount;
+					continue;
+				}
+
+				const double scanStart = FPlatformTime::Seconds();
+				scanResult += ScanNeighbours(*generator->GetVoxel());
+				scanSeconds += FPlatformTime::Seconds() - scanStart;
+			}
+
+			bestGenerateSeconds = FMath::Min(bestGenerateSeconds, generateSeconds);
+			bestScanSeconds = FMath::Min(bestScanSeconds, scanSeconds);
+		}
+
+		AddInfo(FString::Printf(TEXT("%s: generate %.3f ms, neighbour scan %.3f ms (%d seeds, %d faces)"),
+			layout.mName,
+			bestGenerateSeconds * 1000.0,
+			bestScanSeconds * 1000.0,
+			BenchmarkSeedCount,
+			static_cast<int32>(scanResult)
+		));
+	}
+
+	TestEqual(TEXT("Failed generations"), failedCount, 0);
+	return failedCount == 0;
+}
+
+#endif
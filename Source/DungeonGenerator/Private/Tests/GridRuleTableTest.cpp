@@ -0,0 +1,274 @@
+/**
+グリッドのメッシュ生成規則の表のテスト ソースファイル
+
+\author		Shun Moriya
+\copyright	2023- Shun Moriya
+All Rights Reserved.
+*/
+
+#include "Core/Grid.h"
+#include <Misc/AutomationTest.h>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	/*
+	表に置き換える前のGrid::CanBuild系の判定
+	表が同じ結果を返すか比較するために残しています
+	*/
+	bool OldCanBuildFloor(const dungeon::Grid& self, const dungeon::Grid& toGrid, const bool checkNoMeshGeneration) noexcept
+	{
+		if (checkNoMeshGeneration && self.IsNoFloorMeshGeneration())
+			return false;
+
+		if (self.IsKindOfRoomType())
+		{
+			return
+				toGrid.GetIdentifier() != self.GetIdentifier() ||
+				toGrid.IsKindOfAisleType() ||
+				toGrid.IsKindOfSlopeType() ||
+				toGrid.IsKindOfSpatialType();
+		}
+		else if (self.IsKindOfAisleType())
+		{
+			return
+				toGrid.GetIdentifier() != self.GetIdentifier() ||
+				toGrid.IsKindOfRoomType() ||
+				toGrid.IsKindOfAisleType() ||
+				toGrid.IsKindOfSlopeType() ||
+				toGrid.IsKindOfSpatialType();
+		}
+
+		return false;
+	}
+
+	bool OldCanBuildRoof(const dungeon::Grid& self, const dungeon::Grid& toGrid, const bool checkNoMeshGeneration) noexcept
+	{
+		if (checkNoMeshGeneration && self.IsNoRoofMeshGeneration())
+			return false;
+
+		if (self.IsKindOfRoomType())
+		{
+			return
+				(toGrid.GetType() == dungeon::Grid::Type::Deck || toGrid.GetType() == dungeon::Grid::Type::Gate) ||
+				toGrid.IsKindOfAisleType() ||
+				toGrid.IsKindOfSlopeType() ||
+				toGrid.IsKindOfSpatialType();
+		}
+		else if (self.IsKindOfAisleType())
+		{
+			return
+				toGrid.IsKindOfRoomType() ||
+				toGrid.IsKindOfAisleType() ||
+				toGrid.IsKindOfSlopeType() ||
+				toGrid.IsKindOfSpatialType();
+		}
+		else if (self.IsKindOfSlopeType())
+		{
+			return
+				toGrid.IsKindOfRoomType() ||
+				toGrid.IsKindOfAisleType() ||
+				toGrid.GetType() == dungeon::Grid::Type::Slope ||
+				toGrid.IsKindOfSpatialType();
+		}
+
+		return false;
+	}
+
+	bool OldCanBuildWall(const dungeon::Grid& self, const dungeon::Grid& toGrid, const dungeon::Direction::Index direction, const bool mergeRooms, const bool minimap) noexcept
+	{
+		// 部屋と部屋の間に壁を生成する？
+		if (!mergeRooms)
+		{
+			/*
+			部屋と部屋が隣接している場合、
+			グリッドの識別番号（＝部屋の識別番号）が不一致なら壁がある
+			*/
+			if (self.IsKindOfRoomTypeWithoutGate() && toGrid.IsKindOfRoomTypeWithoutGate())
+			{
+				return self.GetIdentifier() != toGrid.GetIdentifier();
+			}
+		}
+
+		if (self.IsKindOfGateType())
+		{
+			if (toGrid.IsKindOfRoomType() || toGrid.IsKindOfSlopeType())
+			{
+				// 識別子が異なっていて、かつ方向が交差していたら壁
+				return
+					self.GetIdentifier() != toGrid.GetIdentifier() &&
+					self.GetDirection().IsNorthSouth() != dungeon::Direction::IsNorthSouth(direction);
+			}
+
+			// 空間なら壁
+			return toGrid.IsKindOfSpatialType();
+		}
+		else if (self.IsKindOfRoomTypeWithoutGate())
+		{
+			// 門は部屋系のグリッドでもあるので注意
+			return
+				toGrid.IsKindOfAisleType() ||
+				(!minimap && toGrid.IsKindOfSlopeType()) ||
+				toGrid.IsKindOfSpatialType();
+		}
+		else if (self.IsKindOfAisleType())
+		{
+			if (toGrid.IsKindOfAisleType() || toGrid.IsKindOfSlopeType())
+			{
+				// 通路の識別子が違うなら壁
+				return toGrid.GetIdentifier() != self.GetIdentifier();
+			}
+
+			return
+				toGrid.IsKindOfRoomTypeWithoutGate() ||
+				toGrid.IsKindOfSpatialType();
+		}
+		else if (self.GetType() == dungeon::Grid::Type::Slope)
+		{
+			if (toGrid.IsKindOfSlopeType())
+			{
+				// 方向が交差していたら壁
+				// グリッドの識別番号が不一致なら壁がある
+				return
+					(toGrid.GetDirection().IsNorthSouth() != dungeon::Direction::IsNorthSouth(direction)) ||
+					(toGrid.GetIdentifier() != self.GetIdentifier());
+			}
+
+			return toGrid.IsKindOfSpatialType();
+		}
+		else if (self.GetType() == dungeon::Grid::Type::Atrium)
+		{
+			if (toGrid.IsKindOfSlopeType())
+			{
+				// 方向が交差していたら壁
+				// グリッドの識別番号が不一致なら壁がある
+				return toGrid.GetDirection().IsNorthSouth() != dungeon::Direction::IsNorthSouth(direction) ||
+					(toGrid.GetIdentifier() != self.GetIdentifier());
+			}
+
+			return toGrid.IsKindOfSpatialType();
+		}
+
+		return false;
+	}
+
+	bool OldCanBuildPillar(const dungeon::Grid& self, const dungeon::Grid& toGrid) noexcept
+	{
+		return
+			toGrid.IsHorizontallyPassable() &&
+			(
+				toGrid.GetType() != dungeon::Grid::Type::Empty &&
+				/*result.GetType() != dungeon::Grid::Type::Gate &&*/
+				toGrid.GetType() != dungeon::Grid::Type::Atrium &&
+				toGrid.GetType() != dungeon::Grid::Type::Slope
+			);
+	}
+
+	bool OldCanBuildGate(const dungeon::Grid& self, const dungeon::Grid& toGrid, const dungeon::Direction::Index direction) noexcept
+	{
+		if (self.GetType() == dungeon::Grid::Type::Gate)
+		{
+			/*
+			門と門の間に通路が無い場合は、
+			ゴールと反対方向のグリッドのみ門を生成する
+			*/
+			if (toGrid.GetType() == dungeon::Grid::Type::Gate)
+			{
+				return
+					self.GetDirection() == toGrid.GetDirection() &&
+					self.GetDirection().Inverse() == dungeon::Direction(direction);
+			}
+			/*
+			階段の正面が門と同じ方向なら門を生成する
+			*/
+			else if (toGrid.IsKindOfSlopeType())
+			{
+				return
+					self.GetDirection().IsNorthSouth() == toGrid.GetDirection().IsNorthSouth() &&
+					self.GetDirection().IsNorthSouth() == dungeon::Direction(direction).IsNorthSouth();
+			}
+
+			return toGrid.IsKindOfAisleType();
+		}
+
+		return false;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonGridRuleTableTest, "DungeonGenerator.Core.GridRuleTable", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+/*
+種類、方向、識別子、メッシュ生成禁止の全ての組み合わせで、表による判定と元の判定を比較します
+*/
+bool FDungeonGridRuleTableTest::RunTest(const FString& Parameters)
+{
+	// 一致する識別子、異なる識別子、無効な識別子
+	static const uint16_t identifiers[] = { 1, 2, static_cast<uint16_t>(~0) };
+
+	int32 mismatchCount = 0;
+	const auto compare = [this, &mismatchCount](const TCHAR* name, const dungeon::Grid& self, const dungeon::Grid& toGrid, const bool actual, const bool expected)
+		{
+			if (actual == expected)
+				return;
+
+			// 最初の数件だけ詳細を出力します
+			if (mismatchCount < 16)
+			{
+				AddError(FString::Printf(TEXT("%s: self(type %d, direction %d, identifier %d) to(type %d, direction %d, identifier %d) returned %d"),
+					name,
+					static_cast<int32>(self.GetType()), static_cast<int32>(self.GetDirection().Get()), static_cast<int32>(self.GetIdentifier()),
+					static_cast<int32>(toGrid.GetType()), static_cast<int32>(toGrid.GetDirection().Get()), static_cast<int32>(toGrid.GetIdentifier()),
+					actual ? 1 : 0));
+			}
+			++mismatchCount;
+		};
+
+	for (uint8_t selfType = 0; selfType < dungeon::Grid::TypeSize; ++selfType)
+	{
+		for (uint8_t toType = 0; toType < dungeon::Grid::TypeSize; ++toType)
+		{
+			for (uint8_t selfDirection = 0; selfDirection < 4; ++selfDirection)
+			{
+				for (uint8_t toDirection = 0; toDirection < 4; ++toDirection)
+				{
+					for (const uint16_t selfIdentifier : identifiers)
+					{
+						for (const uint16_t toIdentifier : identifiers)
+						{
+							for (uint8_t noMeshGeneration = 0; noMeshGeneration < 4; ++noMeshGeneration)
+							{
+								dungeon::Grid self(static_cast<dungeon::Grid::Type>(selfType), dungeon::Direction(static_cast<dungeon::Direction::Index>(selfDirection)), selfIdentifier);
+								self.SetNoMeshGeneration((noMeshGeneration & 1) != 0, (noMeshGeneration & 2) != 0);
+								const dungeon::Grid toGrid(static_cast<dungeon::Grid::Type>(toType), dungeon::Direction(static_cast<dungeon::Direction::Index>(toDirection)), toIdentifier);
+
+								for (const bool checkNoMeshGeneration : { false, true })
+								{
+									compare(TEXT("CanBuildFloor"), self, toGrid, self.CanBuildFloor(toGrid, checkNoMeshGeneration), OldCanBuildFloor(self, toGrid, checkNoMeshGeneration));
+									compare(TEXT("CanBuildRoof"), self, toGrid, self.CanBuildRoof(toGrid, checkNoMeshGeneration), OldCanBuildRoof(self, toGrid, checkNoMeshGeneration));
+								}
+								compare(TEXT("CanBuildPillar"), self, toGrid, self.CanBuildPillar(toGrid), OldCanBuildPillar(self, toGrid));
+
+								for (uint8_t direction = 0; direction < 4; ++direction)
+								{
+									const auto index = static_cast<dungeon::Direction::Index>(direction);
+									for (const bool mergeRooms : { false, true })
+									{
+										compare(TEXT("CanBuildWall"), self, toGrid, self.CanBuildWall(toGrid, index, mergeRooms), OldCanBuildWall(self, toGrid, index, mergeRooms, false));
+										compare(TEXT("CanBuildWallForMinimap"), self, toGrid, self.CanBuildWallForMinimap(toGrid, index, mergeRooms), OldCanBuildWall(self, toGrid, index, mergeRooms, true));
+									}
+									compare(TEXT("CanBuildGate"), self, toGrid, self.CanBuildGate(toGrid, index), OldCanBuildGate(self, toGrid, index));
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	TestEqual(TEXT("Mismatched rule results"), mismatchCount, 0);
+	return mismatchCount == 0;
+}
+
+#endif
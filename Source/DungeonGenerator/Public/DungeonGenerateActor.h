@@ -11,9 +11,11 @@ All Rights Reserved.
 #include "DungeonGenerateActor.generated.h"
 
 class CDungeonGeneratorCore;
+class CDungeonMeshChunkBuilder;
 class UDungeonGenerateParameter;
 class UDungeonMiniMapTextureLayer;
 class UDungeonTransactionalHierarchicalInstancedStaticMeshComponent;
+class UStaticMeshComponent;
 
 namespace dungeon
 {
@@ -56,6 +58,14 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "DungeonGenerator")
 		void DestroyDungeon();
 
+	/**
+	Spawns hidden actors in advance so that the next generation can reuse them
+	\param[in]	actorClass	Class of actor to spawn
+	\param[in]	count		Number of hidden actors to keep
+	*/
+	UFUNCTION(BlueprintCallable, Category = "DungeonGenerator")
+		void PrewarmActors(TSubclassOf<AActor> actorClass, const int32 count);
+
 	/**
 	Finds the floor from the world Z coordinate
 	\param[in]	z	Z coordinate of world
@@ -94,22 +104,47 @@ public:
 	virtual void PreInitializeComponents() override;
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Destroyed() override;
 	virtual void Tick(float DeltaSeconds) override;
 #if WITH_EDITOR
 	virtual bool ShouldTickIfViewportsOnly() const override;
 #endif
 
 private:
-	static void BeginAddInstance(TArray<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent*>& meshs);
+	/**
+	区画と階層毎のコンポーネントと、追加を待っているトランスフォーム
+	*/
+	struct InstanceBatch final
+	{
+		UDungeonTransactionalHierarchicalInstancedStaticMeshComponent* mComponent = nullptr;
+		TArray<FTransform> mTransforms;
+	};
+	// スタティックメッシュと区画（X、Yは区画、Zは階層）
+	using InstanceBatchKey = TTuple<const UStaticMesh*, FIntVector>;
+	using InstanceBatchMap = TMap<InstanceBatchKey, InstanceBatch>;
+
+	static void BeginAddInstance(InstanceBatchMap& batches);
+
+	void AddInstance(TArray<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent*>& meshs, InstanceBatchMap& batches, UStaticMesh* staticMesh, const FTransform& transform);
+
+	static void EndAddInstance(TArray<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent*>& meshs, InstanceBatchMap& batches);
+
+	void DestroyInstances();
+
+	FIntVector ToInstanceSector(const FVector& location) const;
+
+	void AddTerrainMesh(TArray<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent*>& meshs, InstanceBatchMap& batches, UStaticMesh* staticMesh, const FTransform& transform);
 
-	static void AddInstance(TArray<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent*>& meshs, const UStaticMesh* staticMesh, const FTransform& transform);
+	void BuildMeshChunks();
 
-	static void EndAddInstance(TArray<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent*>& meshs);
+	template<typename T>
+	static void DestroyComponents(TArray<T*>& components);
 
-	static inline FBox ToWorldBoundingBox(const std::shared_ptr<const dungeon::Room>& room, const float gridSize);
+	static inline FBox ToWorldBoundingBox(const dungeon::Room& room, const float gridSize);
 
 	void PreGenerateImplementation();
 	void PostGenerateImplementation();
+	void ReleaseImplementation();
 	void DestroyImplementation();
 	void MovePlayerStart();
 
@@ -126,6 +161,20 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DungeonGenerator")
 		bool InstancedStaticMesh = false;
 
+	/*
+	Merges the terrain meshes into one static mesh per chunk instead of instancing them.
+	Collision is simplified to boxes. Slope meshes and meshes that cannot be read from the CPU remain instanced.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DungeonGenerator", meta = (EditCondition = "InstancedStaticMesh"))
+		bool MergeMeshChunks = false;
+
+	/*
+	Number of grids on each horizontal side of a chunk.
+	Instanced components are created per part mesh, chunk and floor; merged meshes per chunk and grid layer.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DungeonGenerator", meta = (EditCondition = "InstancedStaticMesh", ClampMin = "1"))
+		int32 MeshChunkSize = 16;
+
 	UPROPERTY(Transient, BlueprintReadOnly, Category = "DungeonGenerator")
 		TArray<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent*> FloorMeshs;
 
@@ -144,6 +193,9 @@ protected:
 	UPROPERTY(Transient, BlueprintReadOnly, Category = "DungeonGenerator")
 		TArray<UDungeonTransactionalHierarchicalInstancedStaticMeshComponent*> PillarMeshs;
 
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "DungeonGenerator")
+		TArray<UStaticMeshComponent*> ChunkMeshs;
+
 	// event
 	UPROPERTY(BlueprintAssignable, Category = "Event")
 		FDungeonGeneratorActorSignature OnCreateFloor;
@@ -218,6 +270,10 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Transient, Category = "DungeonGenerator|Debug")
 		bool ShowVoxelGridTypeAtPlayerLocation = false;
 
+	// Displays how many times the aisle search expanded each voxel grid (recorded from the next generation)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Transient, Category = "DungeonGenerator|Debug")
+		bool ShowAisleSearchHeatmap = false;
+
 private:
 	void DrawDebugInformation();
 #endif
@@ -226,5 +282,16 @@ private:
 	// Cache of the UIDungeonMiniMapTextureLayer
 	std::shared_ptr<CDungeonGeneratorCore> mDungeonGeneratorCore;
 
+	// コンポーネントはUPROPERTYの配列が保持しているので生ポインタで参照する
+	InstanceBatchMap mFloorBatches;
+	InstanceBatchMap mSlopeBatches;
+	InstanceBatchMap mWallBatches;
+	InstanceBatchMap mRoomRoofBatches;
+	InstanceBatchMap mAisleRoofBatches;
+	InstanceBatchMap mPillarBatches;
+
+	// MergeMeshChunksが有効な時だけ生成中に存在する
+	std::shared_ptr<CDungeonMeshChunkBuilder> mMeshChunkBuilder;
+
 	bool mPostGenerated = false;
 };
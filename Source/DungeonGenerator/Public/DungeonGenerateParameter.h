@@ -45,6 +45,28 @@ enum class EDungeonPartsSelectionMethod : uint8
 	Direction,
 };
 
+/**
+Aisle search method
+*/
+UENUM(BlueprintType)
+enum class EDungeonAisleSearchMode : uint8
+{
+	Standard,
+	Weighted,
+	Bidirectional,
+};
+
+/**
+Voxel memory layout
+*/
+UENUM(BlueprintType)
+enum class EDungeonVoxelLayout : uint8
+{
+	Linear,
+	Tiled,
+	Sparse,
+};
+
 /**
 Parts transform
 */
@@ -299,6 +321,30 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "DungeonGenerator", BlueprintReadWrite, meta = (ClampMin = "0"))
 		int32 VerticalRoomMargin = 0;
 
+	//! Search aisles on multiple threads (the generated dungeon is the same as a single-threaded search)
+	UPROPERTY(EditAnywhere, Category = "DungeonGenerator", BlueprintReadWrite)
+		bool ParallelAisleRouting = false;
+
+	//! Search aisles hierarchically (HPA*) to speed up long aisles in large dungeons. Aisles are not always the shortest. Parallel aisle routing is ignored when enabled.
+	UPROPERTY(EditAnywhere, Category = "DungeonGenerator", BlueprintReadWrite)
+		bool HierarchicalAisleRouting = false;
+
+	//! Cache gate candidates on the room perimeter to speed up the gate search. Gate positions differ from the default search, so the same seed generates a different dungeon.
+	UPROPERTY(EditAnywhere, Category = "DungeonGenerator", BlueprintReadWrite)
+		bool CacheGateCandidates = false;
+
+	//! Aisle search method. Weighted and Bidirectional expand fewer nodes, but aisles are not always the shortest and their extra length is not bounded.
+	UPROPERTY(EditAnywhere, Category = "DungeonGenerator", BlueprintReadWrite)
+		EDungeonAisleSearchMode AisleSearchMode = EDungeonAisleSearchMode::Standard;
+
+	//! Heuristic weight of the weighted aisle search. Larger values expand fewer nodes and tend to produce longer aisles.
+	UPROPERTY(EditAnywhere, Category = "DungeonGenerator", BlueprintReadWrite, meta = (ClampMin = "1.0"))
+		float AisleHeuristicsWeight = 1.5f;
+
+	//! Voxel memory layout. Tiled speeds up neighbour lookups; Sparse allocates only 8x8x8 bricks that contain non-empty grids, saving memory when rooms are far apart.
+	UPROPERTY(EditAnywhere, Category = "DungeonGenerator", BlueprintReadWrite)
+		EDungeonVoxelLayout VoxelLayout = EDungeonVoxelLayout::Linear;
+
 	//! voxel size
 	UPROPERTY(EditAnywhere, Category = "DungeonGenerator", BlueprintReadOnly)
 		float GridSize = 100.f;
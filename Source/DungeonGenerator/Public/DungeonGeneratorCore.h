@@ -15,6 +15,7 @@ All Rights Reserved.
 #include <memory>
 
 // Forward declaration
+class CDungeonActorPool;
 class UDungeonGenerateParameter;
 class ULevelStreamingDynamic;
 class UStaticMesh;
@@ -23,9 +24,11 @@ class AStaticMeshActor;
 
 namespace dungeon
 {
+	class FeatureMask;
 	class Identifier;
 	class Generator;
 	class Room;
+	class RouteCache;
 }
 
 /*
@@ -82,6 +85,21 @@ public:
 	*/
 	void Clear();
 
+	/**
+	Spawns inactive actors into the pool so that later generations can reuse them
+	\param[in]	actorClass	Class of actor to spawn
+	\param[in]	folderPath	Folder path in the outliner
+	\param[in]	count		Number of inactive actors to keep in the pool
+	*/
+	void PrewarmActors(UClass* actorClass, const FName& folderPath, const int32 count) const;
+
+	/**
+	Records how many times the aisle search expanded each voxel grid from the next generation
+	Used to draw the heatmap in DrawDebugInformation
+	\param[in]	enable	true to record
+	*/
+	void EnableAisleSearchHeatmap(const bool enable);
+
 	/**
 	Get start position
 	\return		Coordinates of start position
@@ -142,7 +160,7 @@ public:
 	std::shared_ptr<const dungeon::Generator> GetGenerator() const;
 
 #if WITH_EDITOR
-	void DrawDebugInformation(const bool showRoomAisleInfomation, const bool showVoxelGridType) const;
+	void DrawDebugInformation(const bool showRoomAisleInfomation, const bool showVoxelGridType, const bool showAisleSearchHeatmap = false) const;
 #endif
 
 private:
@@ -171,8 +189,13 @@ private:
 
 	void SpawnRecastNavMesh();
 
+	void ReleaseSpawnedActors() const;
+	void DestroyInactiveActors(UClass* actorClass) const;
 	void DestroySpawnedActors() const;
 	static void DestroySpawnedActors(UWorld* world);
+	static void DestroySpawnedActor(AActor* actor);
+
+	void ResetTerrainEvents();
 
 	template<typename T = AActor> T* FindActor();
 	template<typename T = AActor> const T* FindActor() const;
@@ -197,12 +220,22 @@ private:
 #if WITH_EDITOR
 	void DrawRoomAisleInformation() const;
 	void DrawVoxelGridType() const;
+	void DrawAisleSearchHeatmap() const;
 #endif
 
 private:
 	TWeakObjectPtr<UWorld> mWorld;
 	TWeakObjectPtr<const UDungeonGenerateParameter> mParameter;
 	std::shared_ptr<dungeon::Generator> mGenerator;
+	std::shared_ptr<dungeon::FeatureMask> mFeatureMask;
+	std::shared_ptr<dungeon::RouteCache> mRouteCache;
+	std::shared_ptr<CDungeonActorPool> mActorPool;
+	bool mAisleSearchHeatmap = false;
+
+	// このクラスが生成したアクター（ワールド全体を走査せずに破棄するため）
+	mutable TArray<TWeakObjectPtr<AActor>> mSpawnedActors;
+	// FindActorで見つけたクラス毎のアクター
+	mutable TMap<const UClass*, TWeakObjectPtr<AActor>> mFoundActors;
 
 	AddStaticMeshEvent mOnAddFloor;
 	AddStaticMeshEvent mOnAddSlope;
@@ -305,6 +338,7 @@ inline T* CDungeonGeneratorCore::SpawnActorDeferred(UClass* actorClass, const FN
 #endif
 
 	actor->Tags.Add(GetDungeonGeneratorTag());
+	mSpawnedActors.Add(actor);
 
 	return actor;
 }
@@ -312,25 +346,26 @@ inline T* CDungeonGeneratorCore::SpawnActorDeferred(UClass* actorClass, const FN
 template<typename T>
 inline T* CDungeonGeneratorCore::FindActor()
 {
-	UWorld* world = mWorld.Get();
-	if (IsValid(world))
-	{
-		const TActorIterator<T> iterator(world);
-		if (iterator)
-			return *iterator;
-	}
-	return nullptr;
+	return const_cast<T*>(static_cast<const CDungeonGeneratorCore*>(this)->FindActor<T>());
 }
 
 template<typename T>
 inline const T* CDungeonGeneratorCore::FindActor() const
 {
+	// 見つけたアクターが有効な間はワールドを走査しません
+	TWeakObjectPtr<AActor>& foundActor = mFoundActors.FindOrAdd(T::StaticClass());
+	if (T* actor = Cast<T>(foundActor.Get()))
+		return actor;
+
 	UWorld* world = mWorld.Get();
 	if (IsValid(world))
 	{
 		const TActorIterator<T> iterator(world);
 		if (iterator)
+		{
+			foundActor = *iterator;
 			return *iterator;
+		}
 	}
 	return nullptr;
 }